@@ -0,0 +1,224 @@
+/**
+ * vga32-msx - Memory Arena
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_ARENA_HPP
+#define INCLUDE_ARENA_HPP
+
+#include <stdlib.h>
+#include <string.h>
+
+// Emulator memory carved from one buffer by lifetime (not thread safe: allocate from the emulation side only)
+// - Machine: lives as long as the emulator (RAM, VDP buffers), grows up from the bottom
+// - Cartridge: lives until the ROM is changed (ROM image, SRAM), grows up above Machine
+// - Transient: short-lived work buffers (quick save), grows down from the top
+// A block is reclaimed at once if it is the last one of its scope, otherwise on reset of the scope.
+class Arena
+{
+  public:
+    enum class Scope {
+        Machine = 0,
+        Cartridge = 1,
+        Transient = 2,
+    };
+
+    struct Stats {
+        size_t capacity;
+        size_t used[3];          // bytes held by each scope (including the block headers)
+        size_t dead[3];          // bytes released but not reclaimed yet (fragmentation)
+        size_t highWater;        // highest total of used
+        unsigned int failures;   // allocations that did not fit in the arena
+        unsigned int fallbacks;  // allocations served by the heap instead
+        size_t fallbackBytes;    // bytes allocated from the heap in total
+    };
+
+  private:
+    struct Header {
+        unsigned int size; // including this header
+        unsigned int scope;
+    };
+    static const size_t ALIGN = 8;
+    static const size_t HEADER_SIZE = (sizeof(Header) + ALIGN - 1) & ~(ALIGN - 1);
+
+    unsigned char* buffer;
+    size_t capacity;
+    size_t machineTop;      // Machine: [0, machineTop)
+    size_t cartridgeTop;    // Cartridge: [machineTop, cartridgeTop)
+    size_t transientBottom; // Transient: [transientBottom, capacity)
+    Stats stats;
+
+    inline size_t alignDown(size_t n) { return n & ~(ALIGN - 1); }
+    inline size_t alignUp(size_t n) { return (n + ALIGN - 1) & ~(ALIGN - 1); }
+
+    void updateUsed()
+    {
+        this->stats.used[0] = this->machineTop;
+        this->stats.used[1] = this->cartridgeTop - this->machineTop;
+        this->stats.used[2] = this->capacity - this->transientBottom;
+        size_t total = this->stats.used[0] + this->stats.used[1] + this->stats.used[2];
+        if (this->stats.highWater < total) this->stats.highWater = total;
+    }
+
+  public:
+    Arena(void* buffer, size_t size)
+    {
+        size_t offset = this->alignUp((size_t)buffer) - (size_t)buffer;
+        this->buffer = (unsigned char*)buffer + offset;
+        this->capacity = size < offset ? 0 : this->alignDown(size - offset);
+        memset(&this->stats, 0, sizeof(this->stats));
+        this->stats.capacity = this->capacity;
+        this->reset(Scope::Machine);
+    }
+
+    inline bool contains(const void* ptr) { return this->buffer <= (const unsigned char*)ptr && (const unsigned char*)ptr < this->buffer + this->capacity; }
+    inline size_t available() { return this->transientBottom - this->cartridgeTop; }
+    inline const Stats* getStats() { return &this->stats; }
+
+    // released but unreclaimed bytes per 1000 bytes in use
+    int getFragmentation()
+    {
+        size_t used = this->stats.used[0] + this->stats.used[1] + this->stats.used[2];
+        size_t dead = this->stats.dead[0] + this->stats.dead[1] + this->stats.dead[2];
+        return used ? (int)(dead * 1000 / used) : 0;
+    }
+
+    void resetHighWater()
+    {
+        this->stats.highWater = 0;
+        this->updateUsed();
+    }
+
+    // returns nullptr if the block does not fit (Machine also fails while Cartridge holds blocks)
+    void* allocate(Scope scope, size_t size)
+    {
+        size_t n = this->alignUp(size) + HEADER_SIZE;
+        if (size == 0 || this->available() < n || (Scope::Machine == scope && this->cartridgeTop != this->machineTop)) {
+            this->stats.failures++;
+            return nullptr;
+        }
+        size_t offset;
+        switch (scope) {
+            case Scope::Machine:
+                offset = this->machineTop;
+                this->machineTop += n;
+                this->cartridgeTop = this->machineTop;
+                break;
+            case Scope::Cartridge:
+                offset = this->cartridgeTop;
+                this->cartridgeTop += n;
+                break;
+            default:
+                this->transientBottom -= n;
+                offset = this->transientBottom;
+                break;
+        }
+        Header* header = (Header*)&this->buffer[offset];
+        header->size = (unsigned int)n;
+        header->scope = (unsigned int)scope;
+        this->updateUsed();
+        return &this->buffer[offset + HEADER_SIZE];
+    }
+
+    // releases a block allocated by allocate
+    void release(void* ptr)
+    {
+        if (!ptr || !this->contains(ptr)) return;
+        size_t offset = (unsigned char*)ptr - this->buffer - HEADER_SIZE;
+        Header* header = (Header*)&this->buffer[offset];
+        switch ((Scope)header->scope) {
+            case Scope::Machine:
+                if (offset + header->size == this->machineTop && this->cartridgeTop == this->machineTop) {
+                    this->machineTop = offset;
+                    this->cartridgeTop = offset;
+                    break;
+                }
+                this->stats.dead[0] += header->size;
+                break;
+            case Scope::Cartridge:
+                if (offset + header->size == this->cartridgeTop) {
+                    this->cartridgeTop = offset;
+                    break;
+                }
+                this->stats.dead[1] += header->size;
+                break;
+            default:
+                if (offset == this->transientBottom) {
+                    this->transientBottom += header->size;
+                    break;
+                }
+                this->stats.dead[2] += header->size;
+                break;
+        }
+        this->updateUsed();
+    }
+
+    // releases all blocks of the scope at once (Machine also resets Cartridge and Transient)
+    void reset(Scope scope)
+    {
+        switch (scope) {
+            case Scope::Machine:
+                this->machineTop = 0;
+                this->cartridgeTop = 0;
+                this->transientBottom = this->capacity;
+                memset(this->stats.dead, 0, sizeof(this->stats.dead));
+                break;
+            case Scope::Cartridge:
+                this->cartridgeTop = this->machineTop;
+                this->stats.dead[1] = 0;
+                break;
+            default:
+                this->transientBottom = this->capacity;
+                this->stats.dead[2] = 0;
+                break;
+        }
+        this->updateUsed();
+    }
+
+    // allocate from the arena if any (or the heap if it is full or absent)
+    static void* alloc(Arena* arena, Scope scope, size_t size)
+    {
+        void* result = arena ? arena->allocate(scope, size) : nullptr;
+        if (!result) {
+            result = malloc(size);
+            if (arena && result) {
+                arena->stats.fallbacks++;
+                arena->stats.fallbackBytes += size;
+            }
+        }
+        return result;
+    }
+
+    // release a block allocated by alloc
+    static void free(Arena* arena, void* ptr)
+    {
+        if (arena && arena->contains(ptr)) {
+            arena->release(ptr);
+        } else {
+            ::free(ptr);
+        }
+    }
+};
+
+#endif // INCLUDE_ARENA_HPP
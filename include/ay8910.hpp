@@ -27,17 +27,46 @@
 #ifndef INCLUDE_AY8910_HPP
 #define INCLUDE_AY8910_HPP
 
+#include <math.h>
 #include <string.h>
 
 class AY8910
 {
   private:
     unsigned int clock;
-    unsigned char regMask[16];
     unsigned int levels[32];
     int volumeShift;
 
+    // register writes deferred to the next render
+    struct WriteEvent {
+        unsigned int sample; // the write takes effect before this sample of the next render
+        unsigned char reg;
+        unsigned char value;
+    };
+    WriteEvent events[64];
+    int eventCount;
+
+    // band-limited synthesis: the level changes are added as band-limited steps into the delta buffer, and integrated into the samples
+    static const int BLEP_PHASES = 32; // sub-sample positions of a step
+    static const int BLEP_WIDTH = 16;  // taps of a step (the output is delayed by BLEP_WIDTH / 2 - 1 samples)
+    static const int BLEP_SHIFT = 14;  // the taps of each phase sum to 1 << BLEP_SHIFT
+    static const int BLEP_CHUNK = 256;
+    bool bandLimited;
+    const short* blepTaps; // blepKernel()
+    int blepBuffer[BLEP_CHUNK + BLEP_WIDTH];
+    int blepAccum;
+    int blepLevel[3];
+
   public:
+    AY8910() : bandLimited(false), blepTaps(blepKernel()) {}
+
+    // valid bits of each register
+    static inline const unsigned char* regMask()
+    {
+        static const unsigned char table[16] = {0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x1F, 0xFF, 0x1F, 0x1F, 0x1F, 0xFF, 0xFF, 0x0F, 0xFF, 0xFF};
+        return table;
+    }
+
     struct Context {
         int bobo;
         unsigned char latch;
@@ -65,14 +94,22 @@ class AY8910
         this->ctx.random = 0xFFFF;
         this->ctx.reg[7] = 0x80;
         this->ctx.reg[14] = 0x7F;
-        unsigned char regMask[16] = {0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x1F, 0xFF, 0x1F, 0x1F, 0x1F, 0xFF, 0xFF, 0x0F, 0xFF, 0xFF};
-        memcpy(this->regMask, regMask, sizeof(this->regMask));
         unsigned int levels[32] = {0, 1, 1, 1, 2, 2, 3, 4, 5, 6, 7, 9, 10, 12, 15, 18, 22, 26, 31, 37, 44, 53, 63, 75, 90, 107, 127, 151, 180, 214, 255, 255};
         memcpy(this->levels, levels, sizeof(this->levels));
         for (int i = 0; i < 32; i++) this->levels[i] *= gain;
         this->setVolume(2);
+        this->eventCount = 0;
+        memset(this->blepBuffer, 0, sizeof(this->blepBuffer));
+        this->blepAccum = 0;
+        memset(this->blepLevel, 0, sizeof(this->blepLevel));
     }
 
+    // the output of a channel at the maximum volume (to balance the other sound sources against the PSG)
+    inline int getChannelPeak() { return (int)(this->levels[31] << 1) >> this->volumeShift; }
+
+    // render with the band-limited synthesis instead of sampling the chip every cycles
+    void setBandLimited(bool bandLimited) { this->bandLimited = bandLimited; }
+
     void setVolume(int volume)
     {
         switch (volume) {
@@ -85,7 +122,13 @@ class AY8910
     }
 
     inline void latch(unsigned char value) { this->ctx.latch = value & 0x0F; }
-    inline unsigned char read() { return this->ctx.reg[this->ctx.latch]; }
+    inline unsigned char read()
+    {
+        for (int i = this->eventCount - 1; 0 <= i; i--) {
+            if (this->events[i].reg == this->ctx.latch) return this->events[i].value & regMask()[this->ctx.latch];
+        }
+        return this->ctx.reg[this->ctx.latch];
+    }
     inline unsigned char getPad1() { return this->ctx.reg[0x0E]; }
     inline unsigned char getPad2() { return this->ctx.reg[0x0F]; }
 
@@ -95,9 +138,21 @@ class AY8910
         this->ctx.reg[0x0F] = (~pad2) & 0xFF;
     }
 
+    // Log a write to the latched register that takes effect before the sample'th sample of the next render.
+    // Returns false if the log is full (render the pending samples and retry).
+    inline bool writeDeferred(unsigned int sample, unsigned char value)
+    {
+        if (64 == this->eventCount) return false;
+        this->events[this->eventCount].sample = sample;
+        this->events[this->eventCount].reg = this->ctx.latch;
+        this->events[this->eventCount].value = value;
+        this->eventCount++;
+        return true;
+    }
+
     inline void write(unsigned char value)
     {
-        this->ctx.reg[this->ctx.latch] = value & this->regMask[this->ctx.latch];
+        this->ctx.reg[this->ctx.latch] = value & regMask()[this->ctx.latch];
         switch (this->ctx.latch) {
             case 0: this->ctx.tPeriod[0] = (this->ctx.tPeriod[0] & 0xF000) | (value << 4); break;
             case 1: this->ctx.tPeriod[0] = (this->ctx.tPeriod[0] & 0x0FF0) | (value << 12); break;
@@ -137,41 +192,7 @@ class AY8910
     inline short tick16(unsigned int cycles)
     {
         if (this->ctx.eHolding) {
-            this->ctx.eCounter += cycles;
-            while (0 < this->ctx.eCounter) {
-                this->ctx.eCounter -= this->ctx.ePeriod;
-                this->ctx.eState += this->ctx.eFace;
-                if (this->ctx.eState & 0b00100000) {
-                    switch (this->ctx.reg[13]) {
-                        case 8:
-                        case 12:
-                            this->ctx.eState = this->ctx.eFace == 1 ? 0 : 0x1F;
-                            break;
-                        case 10:
-                        case 14:
-                            this->ctx.eFace = -this->ctx.eFace;
-                            this->ctx.eState = this->ctx.eFace == 1 ? 0 : 0x1F;
-                            break;
-                        case 11:
-                        case 15:
-                            this->ctx.eState = this->ctx.eFace == 1 ? 0 : 0x1F;
-                            this->ctx.eHolding = 1;
-                            this->ctx.eCounter = 0;
-                            break;
-                        case 9:
-                        case 13:
-                            this->ctx.eFace = -this->ctx.eFace;
-                            this->ctx.eState = this->ctx.eFace == 1 ? 0 : 0x1F;
-                            this->ctx.eHolding = 1;
-                            this->ctx.eCounter = 0;
-                            break;
-                        default:
-                            this->ctx.eState = 0;
-                            this->ctx.eHolding = 1;
-                            this->ctx.eCounter = 0;
-                    }
-                }
-            }
+            this->tickEnvelope(cycles);
         }
         if (this->ctx.nPeriod) {
             this->ctx.nCounter += cycles;
@@ -192,6 +213,347 @@ class AY8910
         return mix;
     }
 
+    // Generate count samples at once (the same output as calling tick16(cycles) count times with the deferred writes in between).
+    // The block is split at the deferred writes, and the samples of the following blocks are counted from the end of this one.
+    void render(short* out, int count, unsigned int cycles = 81)
+    {
+        int pos = 0;
+        int done = 0;
+        for (; done < this->eventCount && this->events[done].sample <= (unsigned int)count; done++) {
+            int sample = (int)this->events[done].sample;
+            if (pos < sample) {
+                this->synthesizeBlock(&out[pos], sample - pos, cycles);
+                pos = sample;
+            }
+            unsigned char latch = this->ctx.latch;
+            this->ctx.latch = this->events[done].reg;
+            this->write(this->events[done].value);
+            this->ctx.latch = latch;
+        }
+        if (pos < count) {
+            this->synthesizeBlock(&out[pos], count - pos, cycles);
+        }
+        for (int i = done; i < this->eventCount; i++) {
+            this->events[i - done] = this->events[i];
+            this->events[i - done].sample -= count;
+        }
+        this->eventCount -= done;
+    }
+
+    inline void synthesizeBlock(short* out, int count, unsigned int cycles)
+    {
+        if (this->bandLimited) {
+            for (int pos = 0; pos < count; pos += BLEP_CHUNK) {
+                this->synthesizeBandLimited(&out[pos], count - pos < BLEP_CHUNK ? count - pos : BLEP_CHUNK, cycles);
+            }
+        } else {
+            this->synthesize(out, count, cycles);
+        }
+    }
+
+    // the counters live in locals during the block, and the channels that stay silent in the block only advance their tone counters
+    void synthesize(short* out, int count, unsigned int cycles)
+    {
+        int active[3];
+        int activeCount = 0;
+        bool noise = false;
+        for (int ch = 0; ch < 3; ch++) {
+            if ((this->ctx.reg[8 + ch] & 0x1F) || this->ctx.mix[ch]) {
+                active[activeCount++] = ch;
+                noise |= 0 == (this->ctx.reg[7] & (0x08 << ch));
+            } else {
+                this->advanceCounter(&this->ctx.tCounter[ch], this->ctx.tPeriod[ch], cycles * count, &this->ctx.tUp[ch]);
+            }
+        }
+        if (!noise) {
+            // nobody listens to the noise: just advance the generator
+            unsigned int up = this->ctx.nUp;
+            int steps = this->ctx.nPeriod ? this->advanceCounter(&this->ctx.nCounter, this->ctx.nPeriod, cycles * count, &up) : count;
+            for (int i = 0; i < steps; i++) this->ctx.nUp = this->getRandom();
+        }
+        unsigned int mixer = this->ctx.reg[7];
+        int nPeriod = (int)this->ctx.nPeriod;
+        int nCounter = this->ctx.nCounter;
+        unsigned int nUp = this->ctx.nUp;
+        int tCounter[3];
+        int tPeriod[3];
+        unsigned int tUp[3];
+        int mix[3];
+        unsigned int volume[3];
+        for (int i = 0; i < activeCount; i++) {
+            int ch = active[i];
+            tCounter[i] = this->ctx.tCounter[ch];
+            tPeriod[i] = (int)this->ctx.tPeriod[ch];
+            tUp[i] = this->ctx.tUp[ch];
+            mix[i] = this->ctx.mix[ch];
+            volume[i] = this->ctx.reg[8 + ch] << 1;
+        }
+        for (int n = 0; n < count; n++) {
+            if (this->ctx.eHolding) {
+                this->tickEnvelope(cycles);
+            }
+            if (noise) {
+                if (nPeriod) {
+                    nCounter += cycles;
+                    while (0 <= nCounter) {
+                        nCounter -= nPeriod;
+                        nUp = this->getRandom();
+                    }
+                } else {
+                    nUp = this->getRandom();
+                }
+            }
+            int sum = 0;
+            for (int i = 0; i < activeCount; i++) {
+                int prev = mix[i];
+                if (tPeriod[i]) {
+                    tCounter[i] += cycles;
+                    while (0 <= tCounter[i]) {
+                        tCounter[i] -= tPeriod[i];
+                        tUp[i] ^= 1;
+                    }
+                } else {
+                    tUp[i] = 1;
+                }
+                unsigned int mask = mixer >> active[i];
+                if (((mask & 0x01) || tUp[i]) && ((mask & 0x08) || nUp)) {
+                    mix[i] = volume[i] & 0x20 ? this->levels[this->ctx.eState] : this->levels[volume[i] & 0x1F];
+                } else {
+                    mix[i] >>= 1;
+                }
+                sum += (prev + mix[i]) >> this->volumeShift;
+            }
+            if (32767 < sum)
+                sum = 32767;
+            else if (sum < -32768)
+                sum = -32768;
+            out[n] = (short)sum;
+        }
+        if (noise) {
+            this->ctx.nCounter = nCounter;
+            this->ctx.nUp = nUp;
+        }
+        for (int i = 0; i < activeCount; i++) {
+            int ch = active[i];
+            this->ctx.tCounter[ch] = tCounter[i];
+            this->ctx.tUp[ch] = tUp[i];
+            this->ctx.mix[ch] = mix[i];
+        }
+    }
+
+    // step response of a windowed sinc (Blackman) as the differences between the taps, per sub-sample phase
+    // (built once by the first constructor: the local static is initialized thread-safely)
+    static const short* blepKernel()
+    {
+        static const struct Kernel {
+            short taps[BLEP_PHASES][BLEP_WIDTH];
+            Kernel() { AY8910::makeBlepKernel(taps); }
+        } kernel;
+        return &kernel.taps[0][0];
+    }
+
+    static void makeBlepKernel(short kernel[BLEP_PHASES][BLEP_WIDTH])
+    {
+        const double pi = 3.14159265358979323846;
+        const double cutoff = 0.9; // relative to the Nyquist frequency
+        for (int p = 0; p < BLEP_PHASES; p++) {
+            double taps[BLEP_WIDTH];
+            double sum = 0;
+            for (int k = 0; k < BLEP_WIDTH; k++) {
+                double x = k - (BLEP_WIDTH / 2 - 1) - (double)p / BLEP_PHASES;
+                double sinc = x == 0 ? 1.0 : sin(pi * cutoff * x) / (pi * cutoff * x);
+                double w = (x + BLEP_WIDTH / 2) / BLEP_WIDTH;
+                double window = w <= 0 || 1 <= w ? 0 : 0.42 - 0.5 * cos(2 * pi * w) + 0.08 * cos(4 * pi * w);
+                taps[k] = sinc * window;
+                sum += taps[k];
+            }
+            // normalize so that a step settles exactly to its height
+            int total = 0;
+            int peak = 0;
+            for (int k = 0; k < BLEP_WIDTH; k++) {
+                kernel[p][k] = (short)floor(taps[k] * (1 << BLEP_SHIFT) / sum + 0.5);
+                total += kernel[p][k];
+                if (kernel[p][peak] < kernel[p][k]) peak = k;
+            }
+            kernel[p][peak] += (1 << BLEP_SHIFT) - total;
+        }
+    }
+
+    inline void addStep(int time, unsigned int cycles, int delta)
+    {
+        int n = time / (int)cycles;
+        const short* taps = this->blepTaps + (time % (int)cycles) * BLEP_PHASES / (int)cycles * BLEP_WIDTH;
+        int* dst = &this->blepBuffer[n];
+        for (int k = 0; k < BLEP_WIDTH; k++) {
+            dst[k] += delta * taps[k];
+        }
+    }
+
+    inline int getLevel(int ch, unsigned int mixer, unsigned int nUp)
+    {
+        unsigned int mask = mixer >> ch;
+        if (((mask & 0x01) || !this->ctx.tPeriod[ch] || this->ctx.tUp[ch]) && ((mask & 0x08) || nUp)) {
+            unsigned int volume = this->ctx.reg[8 + ch] << 1;
+            return (int)((volume & 0x20 ? this->levels[this->ctx.eState] : this->levels[volume & 0x1F]) << 1) >> this->volumeShift;
+        }
+        return 0;
+    }
+
+    // Band-limited synthesis of up to BLEP_CHUNK samples: time runs in the counter units (cycles per sample),
+    // the loop jumps from an edge of the tone/noise/envelope generators to the next one,
+    // and only the audible generators make edges (the others are advanced at once at the end).
+    void synthesizeBandLimited(short* out, int count, unsigned int cycles)
+    {
+        const int end = count * (int)cycles;
+        unsigned int mixer = this->ctx.reg[7];
+        bool tone[3];
+        bool noise = false;
+        bool envelope = false;
+        for (int ch = 0; ch < 3; ch++) {
+            unsigned int volume = this->ctx.reg[8 + ch];
+            bool audible = (volume & 0x1F) && 0x09 != ((mixer >> ch) & 0x09);
+            tone[ch] = audible && this->ctx.tPeriod[ch] && 0 == (mixer & (0x01 << ch));
+            noise |= audible && 0 == (mixer & (0x08 << ch));
+            envelope |= 0 != (volume & 0x10); // the envelope is the waveform itself when both tone and noise are off
+        }
+        envelope &= 0 != this->ctx.eHolding;
+        // the noise generator steps every sample with the period 0 (as tick16 does), and the envelope period is 16 at least
+        int nPeriod = this->ctx.nPeriod ? (int)this->ctx.nPeriod : (int)cycles;
+        int ePeriod = this->ctx.ePeriod < 16 ? 16 : (int)this->ctx.ePeriod;
+        int time = 0;
+        while (true) {
+            for (int ch = 0; ch < 3; ch++) {
+                int level = this->getLevel(ch, mixer, this->ctx.nUp);
+                if (level != this->blepLevel[ch]) {
+                    this->addStep(time, cycles, level - this->blepLevel[ch]);
+                    this->blepLevel[ch] = level;
+                }
+            }
+            if (time == end) break;
+            int next = end - time;
+            for (int ch = 0; ch < 3; ch++) {
+                if (tone[ch] && -this->ctx.tCounter[ch] < next) next = -this->ctx.tCounter[ch];
+            }
+            if (noise && -this->ctx.nCounter < next) next = -this->ctx.nCounter;
+            if (envelope && 1 - this->ctx.eCounter < next) next = 1 - this->ctx.eCounter;
+            time += next;
+            for (int ch = 0; ch < 3; ch++) {
+                if (tone[ch]) {
+                    this->ctx.tCounter[ch] += next;
+                    while (0 <= this->ctx.tCounter[ch]) {
+                        this->ctx.tCounter[ch] -= this->ctx.tPeriod[ch];
+                        this->ctx.tUp[ch] ^= 1;
+                    }
+                }
+            }
+            if (noise) {
+                this->ctx.nCounter += next;
+                while (0 <= this->ctx.nCounter) {
+                    this->ctx.nCounter -= nPeriod;
+                    this->ctx.nUp = this->getRandom();
+                }
+            }
+            if (envelope) {
+                this->ctx.eCounter += next;
+                while (0 < this->ctx.eCounter) {
+                    this->ctx.eCounter -= ePeriod;
+                    this->stepEnvelope();
+                }
+            }
+        }
+        // advance the silent generators
+        for (int ch = 0; ch < 3; ch++) {
+            if (!tone[ch]) {
+                this->advanceCounter(&this->ctx.tCounter[ch], this->ctx.tPeriod[ch], end, &this->ctx.tUp[ch]);
+            }
+        }
+        if (!noise) {
+            unsigned int up = this->ctx.nUp;
+            int steps = this->advanceCounter(&this->ctx.nCounter, nPeriod, end, &up);
+            for (int i = 0; i < steps; i++) this->ctx.nUp = this->getRandom();
+        }
+        if (!envelope && this->ctx.eHolding) {
+            this->ctx.eCounter += end;
+            while (0 < this->ctx.eCounter) {
+                this->ctx.eCounter -= ePeriod;
+                this->stepEnvelope();
+            }
+        }
+        // integrate (with a slight leak that removes the DC), then carry the tail of the steps over to the next chunk
+        int accum = this->blepAccum;
+        for (int n = 0; n < count; n++) {
+            accum += this->blepBuffer[n];
+            accum -= accum >> 10;
+            int sample = accum >> BLEP_SHIFT;
+            out[n] = (short)(32767 < sample ? 32767 : (sample < -32768 ? -32768 : sample));
+        }
+        this->blepAccum = accum;
+        memmove(this->blepBuffer, &this->blepBuffer[count], BLEP_WIDTH * sizeof(int));
+        memset(&this->blepBuffer[BLEP_WIDTH], 0, count * sizeof(int));
+    }
+
+    inline void tickEnvelope(unsigned int cycles)
+    {
+        this->ctx.eCounter += cycles;
+        while (0 < this->ctx.eCounter) {
+            this->ctx.eCounter -= this->ctx.ePeriod;
+            this->stepEnvelope();
+        }
+    }
+
+    inline void stepEnvelope()
+    {
+        this->ctx.eState += this->ctx.eFace;
+        if (this->ctx.eState & 0b00100000) {
+            switch (this->ctx.reg[13]) {
+                case 8:
+                case 12:
+                    this->ctx.eState = this->ctx.eFace == 1 ? 0 : 0x1F;
+                    break;
+                case 10:
+                case 14:
+                    this->ctx.eFace = -this->ctx.eFace;
+                    this->ctx.eState = this->ctx.eFace == 1 ? 0 : 0x1F;
+                    break;
+                case 11:
+                case 15:
+                    this->ctx.eState = this->ctx.eFace == 1 ? 0 : 0x1F;
+                    this->ctx.eHolding = 1;
+                    this->ctx.eCounter = 0;
+                    break;
+                case 9:
+                case 13:
+                    this->ctx.eFace = -this->ctx.eFace;
+                    this->ctx.eState = this->ctx.eFace == 1 ? 0 : 0x1F;
+                    this->ctx.eHolding = 1;
+                    this->ctx.eCounter = 0;
+                    break;
+                default:
+                    this->ctx.eState = 0;
+                    this->ctx.eHolding = 1;
+                    this->ctx.eCounter = 0;
+            }
+        }
+    }
+
+    // advance a tone/noise counter by cycles as the per-sample loops do, and returns the number of the periods passed
+    inline int advanceCounter(int* counter, unsigned int period, unsigned int cycles, unsigned int* up)
+    {
+        if (!period) {
+            *up = 1;
+            return 0;
+        }
+        int c = *counter + (int)cycles;
+        if (c < 0) {
+            *counter = c;
+            return 0;
+        }
+        int steps = c / (int)period + 1;
+        *counter = c - steps * (int)period;
+        *up ^= steps & 1;
+        return steps;
+    }
+
     inline int getRandom()
     {
         if (this->ctx.random & 1) {
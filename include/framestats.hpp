@@ -0,0 +1,87 @@
+/**
+ * vga32-msx - Frame Statistics
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_FRAMESTATS_HPP
+#define INCLUDE_FRAMESTATS_HPP
+
+// time spent on an emulated frame
+struct FrameStats {
+    unsigned int emulationMicros; // the CPU, the VDP timing and the PSG writes (the emulation thread)
+    unsigned int renderMicros;    // the rendering of the VDP lines (the renderer thread, during the frame)
+    unsigned int idleMicros;      // waiting for the deadline of the next frame (0: late)
+};
+
+// Ring of the latest frame statistics (written and read on the same thread)
+class FrameStatsRing
+{
+  public:
+    static const int SIZE = 128;
+
+  private:
+    FrameStats frames[SIZE];
+    unsigned int count;
+
+  public:
+    FrameStatsRing() : count(0) {}
+
+    inline void push(const FrameStats& stats)
+    {
+        this->frames[this->count % SIZE] = stats;
+        this->count++;
+    }
+
+    // number of the frames recorded so far
+    inline unsigned int getCount() { return this->count; }
+
+    // n: 0 = the latest frame (nullptr: not recorded)
+    inline const FrameStats* get(unsigned int n)
+    {
+        if (SIZE <= n || this->count <= n) return nullptr;
+        return &this->frames[(this->count - 1 - n) % SIZE];
+    }
+
+    // average of the latest frames (up to SIZE)
+    FrameStats average(unsigned int frames = SIZE)
+    {
+        FrameStats result = {0, 0, 0};
+        if (this->count < frames) frames = this->count;
+        if (SIZE < frames) frames = SIZE;
+        if (!frames) return result;
+        unsigned long long emulation = 0, render = 0, idle = 0;
+        for (unsigned int n = 0; n < frames; n++) {
+            const FrameStats* stats = this->get(n);
+            emulation += stats->emulationMicros;
+            render += stats->renderMicros;
+            idle += stats->idleMicros;
+        }
+        result.emulationMicros = (unsigned int)(emulation / frames);
+        result.renderMicros = (unsigned int)(render / frames);
+        result.idleMicros = (unsigned int)(idle / frames);
+        return result;
+    }
+};
+
+#endif // INCLUDE_FRAMESTATS_HPP
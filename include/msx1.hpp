@@ -26,9 +26,17 @@
  */
 #ifndef INCLUDE_MSX1_HPP
 #define INCLUDE_MSX1_HPP
+#if defined(MSX1_PROFILE) && !defined(TMS9918A_PROFILE)
+#define TMS9918A_PROFILE // the time of the VDP is taken from its rendering
+#endif
+#include <chrono>
+#include "arena.hpp"
 #include "ay8910.hpp"
 #include "msx1def.h"
 #include "msx1mmu.hpp"
+#include "scc.hpp"
+#include "soundmixer.hpp"
+#include "soundring.hpp"
 #include "tms9918a.hpp"
 #include "z80.hpp"
 
@@ -47,6 +55,9 @@ class MSX1
         const void* (*getContext)(void);
         int (*getContextSize)(void);
         void (*setContext)(const void* context, int size);
+        void (*sccWrite)(unsigned char offset, unsigned char value); // nullptr: without SCC
+        const SCC::Context* (*getSccContext)(void);                  // nullptr: without SCC
+        void (*setSccContext)(const void* context, int size);        // nullptr: without SCC
     } psgDelegate;
 #endif
   private:
@@ -56,6 +67,7 @@ class MSX1
 #ifndef MSX1_REMOVE_PSG
     const int PSG_CLOCK = 44100;
     void (*audioCallback)(void* arg, void* buffer, size_t size);
+    SoundRing* soundRing;
 #endif
 
     class InternalBuffer
@@ -64,16 +76,20 @@ class MSX1
 #ifndef MSX1_REMOVE_PSG
         short soundBuffer[1024];
         int soundBufferCursor;
+        int soundPending; // samples elapsed but not generated yet (see flushSound)
 #endif
         char* quickSaveBuffer;
         size_t quickSaveBufferPtr;
         size_t quickSaveBufferHeapSize;
+        Arena* arena;
 
         InternalBuffer()
         {
+            this->arena = nullptr;
 #ifndef MSX1_REMOVE_PSG
             memset(this->soundBuffer, 0, sizeof(this->soundBuffer));
             this->soundBufferCursor = 0;
+            this->soundPending = 0;
 #endif
             this->quickSaveBuffer = nullptr;
             this->quickSaveBufferPtr = 0;
@@ -88,7 +104,7 @@ class MSX1
         void safeReleaseQuickSaveBuffer()
         {
             if (this->quickSaveBuffer) {
-                free(this->quickSaveBuffer);
+                Arena::free(this->arena, this->quickSaveBuffer);
                 this->quickSaveBuffer = nullptr;
             }
             this->quickSaveBufferHeapSize = 0;
@@ -100,7 +116,7 @@ class MSX1
                 return true;
             }
             this->safeReleaseQuickSaveBuffer();
-            this->quickSaveBuffer = (char*)malloc(size);
+            this->quickSaveBuffer = (char*)Arena::alloc(this->arena, Arena::Scope::Transient, size);
             if (!this->quickSaveBuffer) {
                 return false;
             }
@@ -150,6 +166,25 @@ class MSX1
     TMS9918A vdp;
 #ifndef MSX1_REMOVE_PSG
     AY8910 psg;
+    SCC scc;
+    SoundMixer mixer;
+#endif
+
+#ifdef MSX1_PROFILE
+    // per-frame output hashes and the time spent in each component, to check a change for both correctness and speed
+    struct Profile {
+        unsigned int frames;
+        unsigned int videoHash; // FNV-1a of the display buffer at the end of the last frame (0: no display buffer)
+        unsigned int soundHash; // FNV-1a of the PSG samples generated in the last frame
+        unsigned long long cpuNanos; // the rest of the frame: the Z80 and the VDP timing (the clock is read per block, not per instruction)
+        unsigned long long vdpNanos; // the rendering of the lines (TMS9918A::renderNanos)
+        unsigned long long psgNanos; // flushSound (per block of samples)
+    } profile;
+
+    void resetProfile()
+    {
+        memset(&this->profile, 0, sizeof(this->profile));
+    }
 #endif
 
     struct Context {
@@ -160,19 +195,31 @@ class MSX1
     } ctx;
     unsigned char* keyCodeMap;
 
+    Arena* arena;     // buffers of the VDP, SRAM and quick save are allocated from it (or the heap if nullptr)
+    void* romBuffer;  // ROM image allocated by allocateRom
+
     ~MSX1()
     {
+        Arena::free(this->arena, this->romBuffer);
     }
 
 #ifndef MSX1_REMOVE_PSG
-    MSX1(TMS9918A::ColorMode colorMode, unsigned char* ram, size_t ramSize, TMS9918A::Context* vram, void (*displayCallback)(void*, int, int, unsigned short*) = nullptr, void (*audioCallback)(void*, void*, size_t) = nullptr)
+    MSX1(TMS9918A::ColorMode colorMode, unsigned char* ram, size_t ramSize, TMS9918A::Context* vram, void (*displayCallback)(void*, int, int, void*) = nullptr, void (*audioCallback)(void*, void*, size_t) = nullptr, Arena* arena = nullptr)
 #else
-    MSX1(TMS9918A::ColorMode colorMode, unsigned char* ram, size_t ramSize, TMS9918A::Context* vram, void (*displayCallback)(void*, int, int, unsigned short*) = nullptr)
+    MSX1(TMS9918A::ColorMode colorMode, unsigned char* ram, size_t ramSize, TMS9918A::Context* vram, void (*displayCallback)(void*, int, int, void*) = nullptr, Arena* arena = nullptr)
 #endif
     {
+        this->arena = arena;
+        this->romBuffer = nullptr;
+        this->ib.arena = arena;
+        this->mmu.arena = arena;
+        this->vdp.setArena(arena);
         memset(&this->keyAssign, 0, sizeof(this->keyAssign));
 #ifndef MSX1_REMOVE_PSG
         this->audioCallback = audioCallback;
+        this->soundRing = nullptr;
+#else
+        memset(&this->psgDelegate, 0, sizeof(this->psgDelegate));
 #endif
         this->mmu.setupRAM(ram, ramSize);
         this->vdp.initialize(
@@ -183,8 +230,19 @@ class MSX1
         this->cpu.setConsumeClockCallback([](void* arg, int cpuClocks) {
             ((MSX1*)arg)->consumeClock(cpuClocks);
         });
+        this->mmu.sccArg = this;
+        this->mmu.sccWrite = [](void* arg, unsigned char offset, unsigned char value) { ((MSX1*)arg)->sccWrite(offset, value); };
+#ifdef Z80_FETCH_CACHE
+        this->cpu.setFetchPageCallback([](void* arg, unsigned short addr) { return ((MSX1*)arg)->mmu.getFetchPage(addr); });
+        this->mmu.remapArg = this;
+        this->mmu.remapped = [](void* arg) { ((MSX1*)arg)->cpu.invalidateFetchCache(); };
+#endif
         this->initPortTable();
         memset(&keyCodes, 0, sizeof(keyCodes));
+#ifdef MSX1_PROFILE
+        this->resetProfile();
+        this->soundHash = 2166136261U;
+#endif
         initKeyCode('0', 0, 0);
         initKeyCode('1', 1, 0);
         initKeyCode('!', 1, 0, true);
@@ -330,7 +388,9 @@ class MSX1
 #ifndef MSX1_REMOVE_PSG
         memset(this->ib.soundBuffer, 0, sizeof(this->ib.soundBuffer));
         this->ib.soundBufferCursor = 0;
+        this->ib.soundPending = 0;
         this->psg.reset(27);
+        this->scc.reset();
 #else
         if (this->psgDelegate.reset) {
             this->psgDelegate.reset();
@@ -343,18 +403,30 @@ class MSX1
         this->mmu.setup(pri, idx, (unsigned char*)data, size, label);
     }
 
+    // data: a ROM image held by the caller, or allocated by allocateRom
     void loadRom(void* data, int size, int romType)
     {
+        if (data != this->romBuffer) {
+            this->releaseCartridge();
+        }
         this->mmu.setupCartridge(1, 2, data, size, romType);
         this->reset();
     }
 
     void ejectRom()
     {
-        this->mmu.clearCartridge();
+        this->releaseCartridge();
         this->reset();
     }
 
+    // ejects the current ROM and returns a buffer for the next ROM image (to be passed to loadRom)
+    void* allocateRom(size_t size)
+    {
+        this->ejectRom();
+        this->romBuffer = Arena::alloc(this->arena, Arena::Scope::Cartridge, size);
+        return this->romBuffer;
+    }
+
     void tick(unsigned char pad1, unsigned char pad2, unsigned char key)
     {
 #ifndef MSX1_REMOVE_PSG
@@ -364,7 +436,7 @@ class MSX1
 #endif
         this->ctx.key = key;
         this->keyCodeMap = nullptr;
-        this->cpu.execute();
+        this->executeFrame();
     }
 
     void tickWithKeyCodeMap(unsigned char pad1, unsigned char pad2, unsigned char* keyCodeMap)
@@ -376,9 +448,17 @@ class MSX1
 #endif
         this->ctx.key = 0;
         this->keyCodeMap = keyCodeMap;
-        this->cpu.execute();
+        this->executeFrame();
+    }
+
+    // skip the rendering of up to maxSkip frames in a row while a frame takes longer than 1/60 sec
+    void setFrameSkip(int maxSkip)
+    {
+        this->vdp.setFrameSkip(maxSkip);
     }
 
+    inline const TMS9918A::FrameSkip& getFrameSkipStats() { return this->vdp.frameSkip; }
+
 #ifndef MSX1_REMOVE_PSG
     size_t getMaxSoundSize()
     {
@@ -387,24 +467,78 @@ class MSX1
 
     size_t getCurrentSoundSize()
     {
+        this->flushSound();
         return this->ib.soundBufferCursor * 2;
     }
 
     void* getSound(size_t* soundSize)
     {
+        this->flushSound();
         *soundSize = this->ib.soundBufferCursor * 2;
         this->ib.soundBufferCursor = 0;
         return this->ib.soundBuffer;
     }
 #endif
 
-    inline unsigned short* getDisplay()
+    inline void* getDisplay()
     {
         return this->vdp.display;
     }
+    // bytes used by the emulator (the instance and the buffers allocated by the VDP)
+    inline size_t getFootprint() { return sizeof(MSX1) + this->vdp.getFootprint().total; }
     inline int getDisplayWidth() { return 256; }
     inline int getDisplayHeight() { return 192; }
 
+#ifndef MSX1_REMOVE_PSG
+    // the generated samples are also written into the ring (consumed by the audio output on another thread)
+    inline void setSoundRing(SoundRing* ring) { this->soundRing = ring; }
+
+    // band-limited PSG synthesis (less aliasing of the high tones, and less work for the usual music)
+    inline void setBandLimitedSound(bool bandLimited) { this->psg.setBandLimited(bandLimited); }
+
+    // generate the elapsed samples in blocks with the deferred PSG writes (at the end of each frame, or when the write log is full)
+    inline void flushSound()
+    {
+#ifdef MSX1_PROFILE
+        long long psgStart = this->profileNanos();
+#endif
+        while (this->ib.soundPending) {
+            int count = (int)(sizeof(this->ib.soundBuffer) / sizeof(short)) - this->ib.soundBufferCursor;
+            if (this->ib.soundPending < count) count = this->ib.soundPending;
+            short* samples = &this->ib.soundBuffer[this->ib.soundBufferCursor];
+            this->psg.render(samples, count, 81);
+            if (this->scc.isActive()) {
+                // 1 SCC channel at the maximum (127 * 15) is as loud as 1 PSG channel
+                int sccGain = this->psg.getChannelPeak() * 256 / (127 * 15);
+                for (int pos = 0; pos < count; pos += SoundMixer::BLOCK) {
+                    int n = count - pos < SoundMixer::BLOCK ? count - pos : SoundMixer::BLOCK;
+                    int* mix = this->mixer.begin(n);
+                    this->mixer.add(&samples[pos], n, 256);
+                    this->scc.render(mix, n, sccGain, (unsigned int)(((unsigned long long)this->CPU_CLOCK << 16) / this->PSG_CLOCK));
+                    this->mixer.end(&samples[pos], n);
+                }
+            }
+#ifdef MSX1_PROFILE
+            this->soundHash = this->fnv1a(this->soundHash, &this->ib.soundBuffer[this->ib.soundBufferCursor], count * sizeof(short));
+#endif
+            if (this->soundRing) {
+                this->soundRing->write(&this->ib.soundBuffer[this->ib.soundBufferCursor], count);
+            }
+            this->ib.soundPending -= count;
+            this->ib.soundBufferCursor += count;
+            if ((int)(sizeof(this->ib.soundBuffer) / sizeof(short)) == this->ib.soundBufferCursor) {
+                this->ib.soundBufferCursor = 0;
+                if (this->audioCallback) {
+                    this->audioCallback(this, ib.soundBuffer, sizeof(ib.soundBuffer));
+                }
+            }
+        }
+#ifdef MSX1_PROFILE
+        this->profile.psgNanos += this->profileNanos() - psgStart;
+#endif
+    }
+#endif
+
     inline void consumeClock(int cpuClocks)
     {
 #ifndef MSX1_REMOVE_PSG
@@ -412,11 +546,7 @@ class MSX1
         this->psg.ctx.bobo += cpuClocks * this->PSG_CLOCK;
         while (0 < this->psg.ctx.bobo) {
             this->psg.ctx.bobo -= this->CPU_CLOCK;
-            this->ib.soundBuffer[this->ib.soundBufferCursor++] = this->psg.tick16(81);
-            this->ib.soundBufferCursor &= sizeof(this->ib.soundBuffer) - 1;
-            if (0 == this->ib.soundBufferCursor && this->audioCallback) {
-                this->audioCallback(this, ib.soundBuffer, sizeof(ib.soundBuffer));
-            }
+            this->ib.soundPending++;
         }
 #endif
         // Asynchronous with VDP
@@ -559,7 +689,14 @@ class MSX1
     {
         this_->psg.latch(value);
     }
-    static inline void outPortA1(MSX1* this_, unsigned char value) { this_->psg.write(value); }
+    static inline void outPortA1(MSX1* this_, unsigned char value)
+    {
+        // the write takes effect when the pending samples are rendered (flushSound)
+        if (!this_->psg.writeDeferred(this_->ib.soundPending, value)) {
+            this_->flushSound();
+            this_->psg.writeDeferred(0, value);
+        }
+    }
 #else
     static inline void outPortA0(MSX1* this_, unsigned char value)
     {
@@ -605,16 +742,23 @@ class MSX1
         }
         this->ib.quickSaveBufferPtr = 0;
         this->writeSaveChunk("BRD", &this->ctx, (int)sizeof(this->ctx));
-        this->writeSaveChunk("Z80", &this->cpu.reg, (int)sizeof(this->cpu.reg));
+        Z80::Register z80;
+        this->cpu.saveRegister(&z80);
+        this->writeSaveChunk("Z80", &z80, (int)sizeof(z80));
         this->writeSaveChunk("MMU", &this->mmu.ctx, (int)sizeof(this->mmu.ctx));
         this->writeSaveChunk("RAM", this->mmu.ram, (int)this->mmu.ramSize);
         if (0 < this->mmu.sramSize) {
             this->writeSaveChunk("SRM", this->mmu.sram, (int)this->mmu.sramSize);
         }
 #ifndef MSX1_REMOVE_PSG
+        this->flushSound();
         this->writeSaveChunk("PSG", &this->psg.ctx, (int)sizeof(this->psg.ctx));
+        this->writeSaveChunk("SCC", &this->scc.ctx, (int)sizeof(this->scc.ctx));
 #else
         this->writeSaveChunk("PSG", this->psgDelegate.getContext(), this->psgDelegate.getContextSize());
+        if (this->psgDelegate.getSccContext) {
+            this->writeSaveChunk("SCC", this->psgDelegate.getSccContext(), (int)sizeof(SCC::Context));
+        }
 #endif
         this->writeSaveChunk("VDP", this->vdp.ctx, (int)sizeof(TMS9918A::Context));
         *size = this->ib.quickSaveBufferPtr;
@@ -641,9 +785,10 @@ class MSX1
             if (0 == strcmp(chunk, "BRD")) {
                 memcpy(&this->ctx, ptr, chunkSize);
             } else if (0 == strcmp(chunk, "Z80")) {
-                memcpy(&this->cpu.reg, ptr, chunkSize);
+                this->cpu.loadRegister(ptr, chunkSize);
             } else if (0 == strcmp(chunk, "MMU")) {
                 memcpy(&this->mmu.ctx, ptr, chunkSize);
+                this->mmu.remap();
                 this->mmu.bankSwitchover();
             } else if (0 == strcmp(chunk, "RAM")) {
                 memcpy(this->mmu.ram, ptr, chunkSize <= (int)this->mmu.ramSize ? chunkSize : this->mmu.ramSize);
@@ -652,8 +797,13 @@ class MSX1
             } else if (0 == strcmp(chunk, "PSG")) {
 #ifndef MSX1_REMOVE_PSG
                 memcpy(&this->psg.ctx, ptr, chunkSize);
+            } else if (0 == strcmp(chunk, "SCC")) {
+                memset(&this->scc.ctx, 0, sizeof(this->scc.ctx));
+                memcpy(&this->scc.ctx, ptr, chunkSize < (int)sizeof(this->scc.ctx) ? chunkSize : sizeof(this->scc.ctx));
 #else
                 this->psgDelegate.setContext(ptr, chunkSize);
+            } else if (0 == strcmp(chunk, "SCC") && this->psgDelegate.setSccContext) {
+                this->psgDelegate.setSccContext(ptr, chunkSize);
 #endif
             } else if (0 == strcmp(chunk, "VDP")) {
                 memcpy(this->vdp.ctx, ptr, chunkSize);
@@ -670,6 +820,78 @@ class MSX1
     }
 
   private:
+    // unmaps the cartridge and releases its memory (ROM image from allocateRom, SRAM)
+    void releaseCartridge()
+    {
+        this->mmu.clearCartridge();
+        this->mmu.releaseSRAM();
+        Arena::free(this->arena, this->romBuffer);
+        this->romBuffer = nullptr;
+        if (this->arena) {
+            this->arena->reset(Arena::Scope::Cartridge);
+        }
+    }
+
+    // a write to the SCC register window (the samples before the write are generated first)
+    inline void sccWrite(unsigned char offset, unsigned char value)
+    {
+#ifndef MSX1_REMOVE_PSG
+        this->flushSound();
+        this->scc.write(offset, value);
+#else
+        if (this->psgDelegate.sccWrite) {
+            this->psgDelegate.sccWrite(offset, value);
+        }
+#endif
+    }
+
+    // execute the CPU until the end of the frame and feed its wall time to the frame skip of the VDP (when enabled)
+    inline void executeFrame()
+    {
+#ifdef MSX1_PROFILE
+        unsigned long long renderNanos = this->vdp.renderNanos;
+        unsigned long long psgNanos = this->profile.psgNanos;
+        long long frameStart = this->profileNanos();
+#endif
+        bool frameSkip = 0 < this->vdp.frameSkip.maxSkip;
+        auto start = frameSkip ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        this->cpu.execute();
+#ifndef MSX1_REMOVE_PSG
+        this->flushSound();
+#endif
+        if (frameSkip) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            this->vdp.updateFrameSkip((unsigned int)elapsed.count());
+        }
+#ifdef MSX1_PROFILE
+        this->profile.vdpNanos += this->vdp.renderNanos - renderNanos;
+        this->profile.cpuNanos += (this->profileNanos() - frameStart) - (this->vdp.renderNanos - renderNanos) - (this->profile.psgNanos - psgNanos);
+        this->profile.frames++;
+        this->profile.videoHash = this->vdp.display && 192 == this->vdp.displayBufferLines ? this->fnv1a(2166136261U, this->vdp.display, this->vdp.displaySize) : 0;
+        this->profile.soundHash = this->soundHash;
+        this->soundHash = 2166136261U;
+#endif
+    }
+
+#ifdef MSX1_PROFILE
+    unsigned int soundHash; // of the current frame
+
+    static inline long long profileNanos()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static inline unsigned int fnv1a(unsigned int hash, const void* data, size_t size)
+    {
+        const unsigned char* p = (const unsigned char*)data;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= p[i];
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+#endif
+
     void writeSaveChunk(const char* name, const void* data, int size)
     {
         memcpy(&this->ib.quickSaveBuffer[this->ib.quickSaveBufferPtr], name, 4);
@@ -690,8 +912,10 @@ class MSX1
         size += this->mmu.sram ? this->mmu.sramSize + 8 : 0; // SRM
 #ifndef MSX1_REMOVE_PSG
         size += sizeof(this->psg.ctx) + 8; // PSG
+        size += sizeof(this->scc.ctx) + 8; // SCC
 #else
-        size += psgDelegate.getContextSize() + 8; // PSG
+        size += psgDelegate.getContextSize() + 8;                          // PSG
+        size += psgDelegate.getSccContext ? sizeof(SCC::Context) + 8 : 0; // SCC
 #endif
         size += sizeof(TMS9918A::Context) + 8; // VDP
         return size;
@@ -40,6 +40,7 @@
 #define MSX1_ROM_TYPE_ASC8_SRAM2 2
 #define MSX1_ROM_TYPE_ASC16 3
 #define MSX1_ROM_TYPE_ASC16_SRAM2 4
+#define MSX1_ROM_TYPE_KONAMI_SCC 5
 #define MSX1_ROM_TYPE_KONAMI 6
 
 #endif /* INCLUDE_MSX1DEF */
@@ -27,6 +27,7 @@
 #ifndef INCLUDE_MSX1MMU_HPP
 #define INCLUDE_MSX1MMU_HPP
 
+#include "arena.hpp"
 #include "msx1def.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -37,12 +38,14 @@ class MSX1MMU
   public:
     // MSX slots are separated by 16KB, but MegaROMs are separated by 8KB or 16KB, so data blocks are managed by 8KB
     struct DataBlock8KB {
-        char label[8];
         unsigned char* ptr;
         bool isRAM;
         bool isCartridge;
     };
 
+    // the data block of each 8KB page in the current primary slots (touched by every memory access, see remap)
+    struct DataBlock8KB* pageTable[8];
+
     struct Slot {
         struct DataBlock8KB data[8];
     } slots[4];
@@ -55,7 +58,8 @@ class MSX1MMU
 
     struct Context {
         unsigned char pri[4];
-        unsigned char reserved[4];
+        unsigned char sccEnabled; // the SCC register window is mapped at 0x9800 (KONAMI_SCC)
+        unsigned char reserved[3];
         unsigned char cpos[2][4]; // cartridge position register (0x2000 * n)
         unsigned char isSelectSRAM[8];
     } ctx;
@@ -65,13 +69,40 @@ class MSX1MMU
     unsigned char* ram;
     size_t sramSize;
     size_t ramSize;
-    unsigned char empty[0x2000];
+
+    // writes to the SCC register window (offset: 0x00-0xFF)
+    void* sccArg;
+    void (*sccWrite)(void* arg, unsigned char offset, unsigned char value);
+
+    // called when the memory map is changed (remap or bankSwitchover)
+    void* remapArg;
+    void (*remapped)(void* arg);
+
+    Arena* arena; // SRAM is allocated from the cartridge scope (or the heap if nullptr)
+
+    char label[4][8][8]; // name of each data block (for debugging)
+
+    // unmapped data block (shared by all instances, filled with 0xFF once and never written)
+    static inline unsigned char* empty()
+    {
+        static struct EmptyBlock {
+            unsigned char data[0x2000];
+            EmptyBlock() { memset(data, 0xFF, sizeof(data)); }
+        } block;
+        return block.data;
+    }
 
     MSX1MMU()
     {
-        memset(this->empty, 0xFF, sizeof(this->empty));
+        this->arena = nullptr;
+        this->sccArg = nullptr;
+        this->sccWrite = nullptr;
+        this->remapArg = nullptr;
+        this->remapped = nullptr;
         memset(&this->slots, 0, sizeof(this->slots));
         for (int i = 0; i < 4; i++) this->setupEmpty(i);
+        memset(&this->ctx, 0, sizeof(this->ctx));
+        this->remap();
         this->sramEnabled = false;
         this->sram = nullptr;
         this->sramSize = 0;
@@ -79,9 +110,15 @@ class MSX1MMU
 
     ~MSX1MMU()
     {
-        if (this->sram) {
-            free(this->sram);
-        }
+        this->releaseSRAM();
+    }
+
+    void releaseSRAM()
+    {
+        Arena::free(this->arena, this->sram);
+        this->sram = nullptr;
+        this->sramSize = 0;
+        this->sramEnabled = false;
     }
 
     void setupEmpty(int pri)
@@ -93,8 +130,8 @@ class MSX1MMU
 
     void setupEmpty(int pri, int idx)
     {
-        strcpy(slots[pri].data[idx].label, "(empty)");
-        slots[pri].data[idx].ptr = empty;
+        strcpy(this->label[pri][idx], "(empty)");
+        slots[pri].data[idx].ptr = empty();
         slots[pri].data[idx].isRAM = false;
         slots[pri].data[idx].isCartridge = false;
     }
@@ -112,7 +149,7 @@ class MSX1MMU
             default: exit(-1); // invalid RAM size
         }
         for (int i = si; i < 8; i++) {
-            strcpy(this->slots[3].data[i].label, "RAM");
+            strcpy(this->label[3][i], "RAM");
             this->slots[3].data[i].isRAM = true;
             this->slots[3].data[i].isCartridge = false;
             this->slots[3].data[i].ptr = &this->ram[(i * 0x2000) & (this->ramSize - 1)];
@@ -128,6 +165,7 @@ class MSX1MMU
                 this->ctx.cpos[i][j] = j;
             }
         }
+        this->remap();
     }
 
     void clearCartridge()
@@ -162,6 +200,7 @@ class MSX1MMU
                 }
                 break;
             case MSX1_ROM_TYPE_KONAMI:
+            case MSX1_ROM_TYPE_KONAMI_SCC:
                 for (int i = 0; i < 4; i++) {
                     this->ctx.cpos[pri - 1][i] = i;
                 }
@@ -179,7 +218,7 @@ class MSX1MMU
                 }
                 this->sramEnabled = true;
                 if (!this->sram) {
-                    this->sram = (unsigned char*)malloc(0x2000);
+                    this->sram = (unsigned char*)Arena::alloc(this->arena, Arena::Scope::Cartridge, 0x2000);
                     this->sramSize = 0x2000;
                 }
                 memset(this->sram, 0, this->sramSize);
@@ -193,9 +232,9 @@ class MSX1MMU
     void setup(int pri, int idx, unsigned char* data, int size, const char* label)
     {
         do {
-            memset(this->slots[pri].data[idx].label, 0, sizeof(this->slots[pri].data[idx].label));
+            memset(this->label[pri][idx], 0, sizeof(this->label[pri][idx]));
             if (label) {
-                strncpy(this->slots[pri].data[idx].label, label, 4);
+                memcpy(this->label[pri][idx], label, strnlen(label, 4));
             }
             this->slots[pri].data[idx].isRAM = false;
             this->slots[pri].data[idx].isCartridge = NULL != label && 0 == strcmp(label, "CART");
@@ -226,6 +265,7 @@ class MSX1MMU
                 }
             }
         }
+        if (this->remapped) this->remapped(this->remapArg);
     }
 
     inline unsigned char getPrimary()
@@ -243,11 +283,29 @@ class MSX1MMU
             this->ctx.pri[page] = pri;
             value >>= 2;
         }
+        this->remap();
+    }
+
+    // resolve the page table from the primary slot register (call after ctx.pri is changed)
+    inline void remap()
+    {
+        for (int i = 0; i < 8; i++) {
+            this->pageTable[i] = &this->slots[this->ctx.pri[i >> 1]].data[i];
+        }
+        if (this->remapped) this->remapped(this->remapArg);
     }
 
     inline struct DataBlock8KB* getDataBlock(unsigned short addr)
     {
-        return &this->slots[this->ctx.pri[(addr & 0b1100000000000000) >> 14]].data[addr / 0x2000];
+        return this->pageTable[addr >> 13];
+    }
+
+    // host memory of the 8KB page at addr for the instruction fetch (nullptr: the SCC register window)
+    inline const unsigned char* getFetchPage(unsigned short addr)
+    {
+        auto data = this->getDataBlock(addr);
+        if (0x8000 == (addr & 0xE000) && data->isCartridge && this->ctx.sccEnabled) return nullptr;
+        return data->ptr;
     }
 
     inline unsigned char read(unsigned short addr)
@@ -269,6 +327,7 @@ class MSX1MMU
                 case MSX1_ROM_TYPE_ASC16: this->asc16(pri - 1, addr, value); return;
                 case MSX1_ROM_TYPE_ASC16_SRAM2: this->asc16sram2(pri - 1, addr, value); return;
                 case MSX1_ROM_TYPE_KONAMI: this->konami(pri - 1, addr, value); return;
+                case MSX1_ROM_TYPE_KONAMI_SCC: this->konamiSCC(pri - 1, addr, value); return;
             }
             puts("DETECT ROM WRITE");
             exit(-1);
@@ -326,6 +385,28 @@ class MSX1MMU
         }
         this->bankSwitchover();
     }
+
+    // NOTE: the SCC registers are write only in this emulation (reading 0x9800-0x987F returns the ROM)
+    inline void konamiSCC(int idx, unsigned short addr, unsigned char value)
+    {
+        int mask = (int)(this->cartridge.size / 0x2000) - 1;
+        switch (addr & 0xF800) {
+            case 0x5000: this->ctx.cpos[idx][0] = value & mask; break;
+            case 0x7000: this->ctx.cpos[idx][1] = value & mask; break;
+            case 0x9000:
+                this->ctx.cpos[idx][2] = value & mask;
+                this->ctx.sccEnabled = 0x3F == (value & 0x3F) ? 1 : 0;
+                break;
+            case 0xB000: this->ctx.cpos[idx][3] = value & mask; break;
+            case 0x9800:
+                if (this->ctx.sccEnabled && this->sccWrite) {
+                    this->sccWrite(this->sccArg, addr & 0xFF, value);
+                }
+                return;
+            default: return;
+        }
+        this->bankSwitchover();
+    }
 };
 
 #endif // INCLUDE_MMU_HPP
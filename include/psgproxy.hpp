@@ -0,0 +1,359 @@
+/**
+ * vga32-msx - AY-3-8910 Cross Thread Proxy
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_PSGPROXY_HPP
+#define INCLUDE_PSGPROXY_HPP
+
+#include <atomic>
+#include <string.h>
+#include <thread>
+#include "ay8910.hpp"
+#include "scc.hpp"
+#include "soundmixer.hpp"
+#include "spsc.hpp"
+
+// Runs an AY8910 (and the SCC of the cartridge) on the audio thread for the emulation thread:
+// the emulation posts the register writes into a queue and reads the registers from a shadow copy,
+// and the audio thread applies the queued writes between the rendered blocks.
+// With a clock (setClock), the writes are stamped with their position in the emulated frame,
+// and the audio thread renders a whole frame at once after endFrame (renderFrame).
+class AY8910Proxy
+{
+  private:
+    enum class CommandType : unsigned char {
+        Write,
+        Reset,
+        Snapshot,
+        Restore,
+        SccRestore,
+        BandLimited,
+        SccWrite,
+        EndOfFrame,
+    };
+
+    struct Command {
+        CommandType type;
+        unsigned char reg;
+        unsigned char value;
+        unsigned char reserved;
+        unsigned short time; // samples from the start of the frame (Write, SccWrite)
+    };
+
+    // owned by the audio thread
+    AY8910 psg;
+    SCC scc;
+    SoundMixer mixer;
+    unsigned int sccClocks; // CPU clocks per sample (16.16 fixed point)
+    unsigned int frameSamples;  // samples per emulated frame (16.16 fixed point)
+    unsigned int frameFraction; // carried over to the next frame
+    int frameCount;             // samples of the frame in progress (0: none)
+    int framePos;               // samples rendered of the frame in progress
+    SPSCRing<Command, 1024> queue;
+    std::atomic<int> queuedFrames;
+    int gain;
+
+    // owned by the emulation thread
+    void* clockArg;
+    unsigned int (*clock)(void* arg); // CPU clocks from the start of the current frame
+
+    // owned by the emulation thread
+    unsigned char latchedReg;
+    unsigned char shadow[16];
+    bool frameOpen; // writes have been posted since the last frame end
+
+    // handed over via Snapshot/Restore/SccRestore
+    AY8910::Context snapshot;
+    AY8910::Context restore;
+    SCC::Context sccSnapshot;
+    SCC::Context sccRestore;
+    std::atomic<bool> snapshotReady;
+
+    void post(CommandType type, unsigned char reg = 0, unsigned char value = 0)
+    {
+        Command command;
+        command.type = type;
+        command.reg = reg;
+        command.value = value;
+        command.reserved = 0;
+        command.time = 0;
+        if (this->clock && (CommandType::Write == type || CommandType::SccWrite == type)) {
+            unsigned long long time = (unsigned long long)this->clock(this->clockArg) * 44100 / 3579545;
+            command.time = (unsigned short)(time < 0xFFFF ? time : 0xFFFF);
+        }
+        if (CommandType::Write == type || CommandType::SccWrite == type) this->frameOpen = true;
+        this->queue.pushWait(command);
+    }
+
+    // audio thread
+    void execute(const Command* command)
+    {
+        switch (command->type) {
+            case CommandType::Write:
+                this->psg.ctx.latch = command->reg;
+                this->psg.write(command->value);
+                break;
+            case CommandType::Reset:
+                this->psg.reset(this->gain);
+                this->scc.reset();
+                break;
+            case CommandType::Snapshot:
+                memcpy(&this->snapshot, &this->psg.ctx, sizeof(this->snapshot));
+                memcpy(&this->sccSnapshot, &this->scc.ctx, sizeof(this->sccSnapshot));
+                this->snapshotReady.store(true, std::memory_order_release);
+                break;
+            case CommandType::Restore:
+                memcpy(&this->psg.ctx, &this->restore, sizeof(this->psg.ctx));
+                break;
+            case CommandType::SccRestore:
+                memcpy(&this->scc.ctx, &this->sccRestore, sizeof(this->scc.ctx));
+                break;
+            case CommandType::BandLimited:
+                this->psg.setBandLimited(0 != command->value);
+                break;
+            case CommandType::SccWrite:
+                this->scc.write(command->reg, command->value);
+                break;
+            case CommandType::EndOfFrame:
+                this->queuedFrames.fetch_sub(1, std::memory_order_relaxed);
+                break;
+        }
+    }
+
+    void renderBlock(short* out, int count, unsigned int cycles)
+    {
+        this->psg.render(out, count, cycles);
+        if (this->scc.isActive()) {
+            int sccGain = this->psg.getChannelPeak() * 256 / (127 * 15);
+            for (int pos = 0; pos < count; pos += SoundMixer::BLOCK) {
+                int n = count - pos < SoundMixer::BLOCK ? count - pos : SoundMixer::BLOCK;
+                int* mix = this->mixer.begin(n);
+                this->mixer.add(&out[pos], n, 256);
+                this->scc.render(mix, n, sccGain, this->sccClocks);
+                this->mixer.end(&out[pos], n);
+            }
+        }
+    }
+
+    // emulation thread: waits until the audio thread has copied its contexts into the snapshots (the audio thread must be running).
+    // The audio thread serves the snapshot only between the frames, so the writes of an unfinished frame are closed as a frame first.
+    void takeSnapshot()
+    {
+        if (this->frameOpen) this->endFrame();
+        this->snapshotReady.store(false, std::memory_order_relaxed);
+        this->post(CommandType::Snapshot);
+        while (!this->snapshotReady.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+
+    void resetShadow()
+    {
+        memset(this->shadow, 0, sizeof(this->shadow));
+        this->shadow[7] = 0x80;
+        this->shadow[14] = 0x7F;
+        this->latchedReg = 0;
+    }
+
+  public:
+    static const int MAX_FRAME_SAMPLES = 768;
+
+    AY8910Proxy(int gain = 27) : queuedFrames(0), snapshotReady(false)
+    {
+        this->frameOpen = false;
+        this->gain = gain;
+        this->psg.reset(gain);
+        this->scc.reset();
+        this->sccClocks = (unsigned int)((3579545ULL << 16) / 44100);
+        this->frameSamples = (unsigned int)((44100ULL * 59736 << 16) / 3579545); // 262 lines of 228 clocks
+        this->frameFraction = 0;
+        this->frameCount = 0;
+        this->framePos = 0;
+        this->clockArg = nullptr;
+        this->clock = nullptr;
+        this->resetShadow();
+    }
+
+    // emulation thread
+    void setClock(void* arg, unsigned int (*clock)(void* arg))
+    {
+        this->clockArg = arg;
+        this->clock = clock;
+    }
+
+    // emulation thread: the writes posted so far make a frame
+    void endFrame()
+    {
+        this->frameOpen = false;
+        this->post(CommandType::EndOfFrame);
+        this->queuedFrames.fetch_add(1, std::memory_order_release);
+    }
+
+    // emulation thread
+    void reset()
+    {
+        this->resetShadow();
+        this->post(CommandType::Reset);
+    }
+
+    inline void latch(unsigned char value) { this->latchedReg = value & 0x0F; }
+
+    inline void write(unsigned char value)
+    {
+        this->shadow[this->latchedReg] = value & AY8910::regMask()[this->latchedReg];
+        if (this->latchedReg < 14) {
+            this->post(CommandType::Write, this->latchedReg, value);
+        }
+    }
+
+    inline unsigned char read()
+    {
+        unsigned char result = this->shadow[this->latchedReg];
+        if (14 <= this->latchedReg) {
+            result |= 0b11000000; // unpush S1/S2
+        }
+        return result;
+    }
+
+    inline void setPads(unsigned char pad1, unsigned char pad2)
+    {
+        this->shadow[0x0E] = (~pad1) & 0xFF;
+        this->shadow[0x0F] = (~pad2) & 0xFF;
+    }
+
+    inline unsigned char getPad1() { return this->shadow[0x0E]; }
+    inline unsigned char getPad2() { return this->shadow[0x0F]; }
+
+    // waits until the audio thread has applied all the preceding writes (the audio thread must be running)
+    const AY8910::Context* getContext()
+    {
+        this->takeSnapshot();
+        this->snapshot.latch = this->latchedReg;
+        this->snapshot.reg[14] = this->shadow[14];
+        this->snapshot.reg[15] = this->shadow[15];
+        return &this->snapshot;
+    }
+
+    inline void sccWrite(unsigned char offset, unsigned char value) { this->post(CommandType::SccWrite, offset, value); }
+
+    inline void setBandLimited(bool bandLimited) { this->post(CommandType::BandLimited, 0, bandLimited ? 1 : 0); }
+
+    inline int getContextSize() { return (int)sizeof(AY8910::Context); }
+
+    // takes effect on the audio thread after the preceding writes (the shadow registers are updated at once)
+    void setContext(const void* context, int size)
+    {
+        // wait for the previous restore to be consumed before overwriting it
+        this->takeSnapshot();
+        memset(&this->restore, 0, sizeof(this->restore));
+        memcpy(&this->restore, context, size < (int)sizeof(this->restore) ? size : sizeof(this->restore));
+        memcpy(this->shadow, this->restore.reg, sizeof(this->shadow));
+        this->latchedReg = this->restore.latch & 0x0F;
+        this->post(CommandType::Restore);
+    }
+
+    // the SCC of the cartridge (waits as getContext)
+    const SCC::Context* getSccContext()
+    {
+        this->takeSnapshot();
+        return &this->sccSnapshot;
+    }
+
+    // takes effect on the audio thread after the preceding writes
+    void setSccContext(const void* context, int size)
+    {
+        this->takeSnapshot();
+        memset(&this->sccRestore, 0, sizeof(this->sccRestore));
+        memcpy(&this->sccRestore, context, size < (int)sizeof(this->sccRestore) ? size : sizeof(this->sccRestore));
+        this->post(CommandType::SccRestore);
+    }
+
+    // audio thread: applies the queued commands (call it also while the output is full, or the emulation may wait for the queue)
+    void apply()
+    {
+        const Command* command;
+        while (nullptr != (command = this->queue.peek())) {
+            this->execute(command);
+            this->queue.drop();
+        }
+    }
+
+    // audio thread: applies the queued commands up to a write or a frame end (while waiting for the frames with renderFrame)
+    void applyControl()
+    {
+        const Command* command;
+        while (nullptr != (command = this->queue.peek())) {
+            if (CommandType::Write == command->type || CommandType::SccWrite == command->type || CommandType::EndOfFrame == command->type) break;
+            this->execute(command);
+            this->queue.drop();
+        }
+    }
+
+    // audio thread: applies the queued commands, then renders count samples
+    void render(short* out, int count, unsigned int cycles = 81)
+    {
+        this->apply();
+        this->renderBlock(out, count, cycles);
+    }
+
+    // audio thread: renders the oldest posted frame with the writes at their stamped positions,
+    // and returns the number of the samples (0: no frame is complete yet).
+    // A frame with more writes than the half of the queue is rendered in parts, so out must be the same buffer of MAX_FRAME_SAMPLES until it completes.
+    int renderFrame(short* out, unsigned int cycles = 81)
+    {
+        bool complete = 0 < this->queuedFrames.load(std::memory_order_acquire);
+        if (!complete && this->queue.size() < this->queue.capacity() / 2) return 0;
+        if (!this->frameCount) {
+            this->frameFraction += this->frameSamples;
+            this->frameCount = (int)(this->frameFraction >> 16);
+            this->frameFraction &= 0xFFFF;
+            this->framePos = 0;
+        }
+        const Command* command;
+        while (nullptr != (command = this->queue.peek())) {
+            CommandType type = command->type;
+            if (CommandType::EndOfFrame == type) {
+                this->execute(command);
+                this->queue.drop();
+                int count = this->frameCount;
+                if (this->framePos < count) {
+                    this->renderBlock(&out[this->framePos], count - this->framePos, cycles);
+                }
+                this->frameCount = 0;
+                return count;
+            }
+            if (CommandType::Write == type || CommandType::SccWrite == type) {
+                int time = command->time < this->frameCount ? command->time : this->frameCount;
+                if (this->framePos < time) {
+                    this->renderBlock(&out[this->framePos], time - this->framePos, cycles);
+                    this->framePos = time;
+                }
+            }
+            this->execute(command);
+            this->queue.drop();
+        }
+        return 0;
+    }
+};
+
+#endif // INCLUDE_PSGPROXY_HPP
@@ -0,0 +1,103 @@
+/**
+ * vga32-msx - Sound Rate Control
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_RATECONTROL_HPP
+#define INCLUDE_RATECONTROL_HPP
+
+// Holds the fill level of a sound ring at its latency by nudging the resampling ratio of the producer by a small fraction
+// (the emulation is paced by its own clock, so that it drifts against the DAC clock)
+class SoundRateControl
+{
+  public:
+    static const int MAX_ADJUST = 328; // 0.5% of 65536 (about 9 cents: not audible as a pitch change)
+
+  private:
+    int integral;
+    int adjust;
+
+  public:
+    SoundRateControl() { this->reset(); }
+
+    void reset()
+    {
+        this->integral = 0;
+        this->adjust = 0;
+    }
+
+    // call it once per produced block with the fill level after the block, and returns the input step of SoundResampler (16.16)
+    unsigned int update(unsigned int fill, unsigned int target)
+    {
+        int error = (int)target - (int)fill; // positive: too few samples are buffered, so produce more
+        this->integral += error;
+        if (MAX_ADJUST * 256 < this->integral) this->integral = MAX_ADJUST * 256;
+        if (this->integral < -MAX_ADJUST * 256) this->integral = -MAX_ADJUST * 256;
+        int adjust = error / 4 + this->integral / 256;
+        if (MAX_ADJUST < adjust) adjust = MAX_ADJUST;
+        if (adjust < -MAX_ADJUST) adjust = -MAX_ADJUST;
+        this->adjust = adjust;
+        return (unsigned int)(65536 - adjust);
+    }
+
+    // current adjustment of the output rate in 1/65536
+    inline int getAdjust() { return this->adjust; }
+};
+
+// Linear interpolating resampler for the ratios near 1 (the state carries over between the blocks)
+class SoundResampler
+{
+  private:
+    unsigned int phase; // 16.16 position of the next output sample (0: the last sample of the previous block)
+    short last;
+
+  public:
+    SoundResampler() { this->reset(); }
+
+    void reset()
+    {
+        this->phase = 0x10000;
+        this->last = 0;
+    }
+
+    // step: input samples per output sample (16.16), and returns the number of the output samples
+    // (out must have a room for count * 65536 / step + 1 samples)
+    int process(const short* in, int count, short* out, unsigned int step)
+    {
+        int produced = 0;
+        unsigned int end = (unsigned int)count << 16;
+        while (this->phase <= end) {
+            int index = (int)(this->phase >> 16);
+            int a = index ? in[index - 1] : this->last;
+            int b = index < count ? in[index] : a;
+            out[produced++] = (short)(a + (((b - a) * (int)((this->phase & 0xFFFF) >> 4)) >> 12));
+            this->phase += step;
+        }
+        this->phase -= end;
+        this->last = in[count - 1];
+        return produced;
+    }
+};
+
+#endif // INCLUDE_RATECONTROL_HPP
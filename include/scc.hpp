@@ -0,0 +1,101 @@
+/**
+ * vga32-msx - Konami SCC
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_SCC_HPP
+#define INCLUDE_SCC_HPP
+
+#include <string.h>
+
+// Konami SCC (wavetable sound chip of the MegaROM cartridges): five channels of 32 signed samples
+class SCC
+{
+  public:
+    struct Context {
+        signed char wave[5][32];
+        unsigned short period[5];
+        unsigned char volume[5];
+        unsigned char enable;
+        unsigned int position[5]; // 16.16 fixed point index into the wave
+    } ctx;
+
+    void reset()
+    {
+        memset(&this->ctx, 0, sizeof(this->ctx));
+    }
+
+    // offset: the address in the register window (0x9800-0x98FF, mirrored through 0x9FFF)
+    inline void write(unsigned char offset, unsigned char value)
+    {
+        if (offset < 0x80) {
+            this->ctx.wave[offset >> 5][offset & 0x1F] = (signed char)value;
+            if (0x60 <= offset) {
+                this->ctx.wave[4][offset & 0x1F] = (signed char)value; // the channel 5 shares the wave of the channel 4
+            }
+            return;
+        }
+        if (0xA0 <= offset) return;
+        offset &= 0x8F; // 0x90-0x9F mirrors 0x80-0x8F
+        if (offset < 0x8A) {
+            int ch = (offset - 0x80) >> 1;
+            if (offset & 1) {
+                this->ctx.period[ch] = (this->ctx.period[ch] & 0x0FF) | ((value & 0x0F) << 8);
+            } else {
+                this->ctx.period[ch] = (this->ctx.period[ch] & 0xF00) | value;
+            }
+        } else if (offset < 0x8F) {
+            this->ctx.volume[offset - 0x8A] = value & 0x0F;
+        } else {
+            this->ctx.enable = value & 0x1F;
+        }
+    }
+
+    inline bool isActive() { return 0 != this->ctx.enable; }
+
+    // Add count samples multiplied by gain into mix.
+    // clocks: the chip clocks per output sample (16.16 fixed point)
+    void render(int* mix, int count, int gain, unsigned int clocks)
+    {
+        for (int ch = 0; ch < 5; ch++) {
+            unsigned int period = this->ctx.period[ch];
+            if (period < 9) continue; // the chip stops the channels with the very short periods
+            unsigned int step = clocks / (period + 1);
+            unsigned int position = this->ctx.position[ch];
+            if (0 == (this->ctx.enable & (1 << ch)) || 0 == this->ctx.volume[ch]) {
+                this->ctx.position[ch] = position + step * count;
+                continue;
+            }
+            const signed char* wave = this->ctx.wave[ch];
+            int level = this->ctx.volume[ch] * gain;
+            for (int i = 0; i < count; i++) {
+                mix[i] += wave[(position >> 16) & 0x1F] * level;
+                position += step;
+            }
+            this->ctx.position[ch] = position;
+        }
+    }
+};
+
+#endif // INCLUDE_SCC_HPP
@@ -0,0 +1,67 @@
+/**
+ * vga32-msx - Sound Mixer
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_SOUNDMIXER_HPP
+#define INCLUDE_SOUNDMIXER_HPP
+
+#include <string.h>
+
+// Mixes the sound sources into a block of fixed-point samples (the gains are 8.8 fixed point), then clamps the whole block at once.
+// The loops have no branches in their bodies, so that the compiler can vectorize them.
+class SoundMixer
+{
+  public:
+    static const int BLOCK = 256;
+
+  private:
+    int mix[BLOCK];
+
+  public:
+    inline int* begin(int count)
+    {
+        memset(this->mix, 0, count * sizeof(int));
+        return this->mix;
+    }
+
+    inline void add(const short* samples, int count, int gain)
+    {
+        for (int i = 0; i < count; i++) {
+            this->mix[i] += samples[i] * gain;
+        }
+    }
+
+    inline void end(short* out, int count)
+    {
+        for (int i = 0; i < count; i++) {
+            int sample = this->mix[i] >> 8;
+            sample = sample < -32768 ? -32768 : sample;
+            sample = 32767 < sample ? 32767 : sample;
+            out[i] = (short)sample;
+        }
+    }
+};
+
+#endif // INCLUDE_SOUNDMIXER_HPP
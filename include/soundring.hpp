@@ -0,0 +1,150 @@
+/**
+ * vga32-msx - Sound Sample Ring
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_SOUNDRING_HPP
+#define INCLUDE_SOUNDRING_HPP
+
+#include <atomic>
+#include "spsc.hpp"
+
+// Sample buffer between the emulation (producer) and the audio output (consumer: DAC DMA or WAV file)
+class SoundRing
+{
+  public:
+    struct Stats {
+        unsigned int fill;            // samples buffered at the moment
+        unsigned int minFill;         // lowest fill seen by the consumer while playing
+        unsigned int maxFill;         // highest fill seen by the consumer while playing
+        unsigned int latency;         // samples buffered before the playback starts (or restarts after an underrun)
+        unsigned int underruns;       // times the consumer ran out of samples while playing
+        unsigned int underrunSamples; // samples substituted by the consumer
+        unsigned int overruns;        // times the producer found the ring full
+        unsigned int overrunSamples;  // samples dropped by the producer
+    };
+
+  private:
+    SPSCRing<short, 8192> ring;
+    std::atomic<unsigned int> latency;
+    // written only by the producer
+    std::atomic<unsigned int> overruns;
+    std::atomic<unsigned int> overrunSamples;
+    // written only by the consumer
+    std::atomic<unsigned int> minFill;
+    std::atomic<unsigned int> maxFill;
+    std::atomic<unsigned int> underruns;
+    std::atomic<unsigned int> underrunSamples;
+    bool priming;
+    short lastSample;
+
+  public:
+    SoundRing() : latency(2048)
+    {
+        this->resetStats();
+        this->priming = true;
+        this->lastSample = 0;
+    }
+
+    inline unsigned int capacity() { return this->ring.capacity(); }
+    inline unsigned int fill() { return this->ring.size(); }
+
+    // number of samples to be buffered before the playback starts
+    void setLatency(unsigned int samples)
+    {
+        if (this->ring.capacity() < samples) samples = this->ring.capacity();
+        this->latency.store(samples, std::memory_order_relaxed);
+    }
+
+    inline unsigned int getLatency() { return this->latency.load(std::memory_order_relaxed); }
+
+    // producer: the samples which do not fit into the ring are dropped
+    inline void write(const short* samples, unsigned int count)
+    {
+        unsigned int written = this->ring.write(samples, count);
+        if (written < count) {
+            this->overruns.fetch_add(1, std::memory_order_relaxed);
+            this->overrunSamples.fetch_add(count - written, std::memory_order_relaxed);
+        }
+    }
+
+    // consumer: always fills count samples (the last sample is held while priming or on an underrun)
+    inline void read(short* samples, unsigned int count)
+    {
+        unsigned int fill = this->ring.size();
+        unsigned int done = 0;
+        if (this->priming && this->latency.load(std::memory_order_relaxed) <= fill) {
+            this->priming = false;
+        }
+        if (!this->priming) {
+            if (fill < this->minFill.load(std::memory_order_relaxed)) this->minFill.store(fill, std::memory_order_relaxed);
+            if (this->maxFill.load(std::memory_order_relaxed) < fill) this->maxFill.store(fill, std::memory_order_relaxed);
+            done = this->ring.read(samples, count);
+            if (done) this->lastSample = samples[done - 1];
+            if (done < count) {
+                this->underruns.fetch_add(1, std::memory_order_relaxed);
+                this->underrunSamples.fetch_add(count - done, std::memory_order_relaxed);
+                this->priming = true;
+            }
+        }
+        for (; done < count; done++) {
+            samples[done] = this->lastSample;
+        }
+    }
+
+    Stats getStats()
+    {
+        Stats stats;
+        stats.fill = this->ring.size();
+        stats.minFill = this->minFill.load(std::memory_order_relaxed);
+        stats.maxFill = this->maxFill.load(std::memory_order_relaxed);
+        stats.latency = this->latency.load(std::memory_order_relaxed);
+        stats.underruns = this->underruns.load(std::memory_order_relaxed);
+        stats.underrunSamples = this->underrunSamples.load(std::memory_order_relaxed);
+        stats.overruns = this->overruns.load(std::memory_order_relaxed);
+        stats.overrunSamples = this->overrunSamples.load(std::memory_order_relaxed);
+        if (stats.maxFill < stats.minFill) stats.minFill = 0; // not played yet
+        return stats;
+    }
+
+    void resetStats()
+    {
+        this->minFill.store(0xFFFFFFFF);
+        this->maxFill.store(0);
+        this->underruns.store(0);
+        this->underrunSamples.store(0);
+        this->overruns.store(0);
+        this->overrunSamples.store(0);
+    }
+
+    // NOTE: call it only while neither the producer nor the consumer is running
+    void clear()
+    {
+        this->ring.clear();
+        this->priming = true;
+        this->lastSample = 0;
+    }
+};
+
+#endif // INCLUDE_SOUNDRING_HPP
@@ -0,0 +1,122 @@
+/**
+ * vga32-msx - Single Producer Single Consumer Ring
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_SPSC_HPP
+#define INCLUDE_SPSC_HPP
+
+#include <atomic>
+#include <thread>
+
+// Lock-free ring buffer between one producer thread and one consumer thread (N must be a power of 2)
+template <typename T, unsigned int N>
+class SPSCRing
+{
+  private:
+    T buffer[N];
+    std::atomic<unsigned int> head; // written only by the producer
+    std::atomic<unsigned int> tail; // written only by the consumer
+
+  public:
+    SPSCRing() : head(0), tail(0) {}
+
+    // producer: returns false if the ring is full
+    inline bool push(const T& value)
+    {
+        unsigned int h = this->head.load(std::memory_order_relaxed);
+        if (N == h - this->tail.load(std::memory_order_acquire)) return false;
+        this->buffer[h & (N - 1)] = value;
+        this->head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // producer: waits until the consumer makes a room
+    inline void pushWait(const T& value)
+    {
+        while (!this->push(value)) std::this_thread::yield();
+    }
+
+    // consumer: returns the oldest element (nullptr: empty) without removing it
+    inline const T* peek()
+    {
+        unsigned int t = this->tail.load(std::memory_order_relaxed);
+        if (t == this->head.load(std::memory_order_acquire)) return nullptr;
+        return &this->buffer[t & (N - 1)];
+    }
+
+    // consumer: removes the element returned by peek
+    inline void drop()
+    {
+        this->tail.store(this->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // consumer: returns false if the ring is empty
+    inline bool pop(T* value)
+    {
+        const T* p = this->peek();
+        if (!p) return false;
+        *value = *p;
+        this->drop();
+        return true;
+    }
+
+    // producer: copies up to count elements and returns the number of copied elements
+    inline unsigned int write(const T* values, unsigned int count)
+    {
+        unsigned int h = this->head.load(std::memory_order_relaxed);
+        unsigned int room = N - (h - this->tail.load(std::memory_order_acquire));
+        if (room < count) count = room;
+        for (unsigned int i = 0; i < count; i++) {
+            this->buffer[(h + i) & (N - 1)] = values[i];
+        }
+        this->head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    // consumer: copies up to count elements and returns the number of copied elements
+    inline unsigned int read(T* values, unsigned int count)
+    {
+        unsigned int t = this->tail.load(std::memory_order_relaxed);
+        unsigned int used = this->head.load(std::memory_order_acquire) - t;
+        if (used < count) count = used;
+        for (unsigned int i = 0; i < count; i++) {
+            values[i] = this->buffer[(t + i) & (N - 1)];
+        }
+        this->tail.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    inline unsigned int size() { return this->head.load(std::memory_order_acquire) - this->tail.load(std::memory_order_acquire); }
+    inline unsigned int capacity() { return N; }
+
+    // NOTE: call it only while neither the producer nor the consumer is running
+    void clear()
+    {
+        this->head.store(0);
+        this->tail.store(0);
+    }
+};
+
+#endif // INCLUDE_SPSC_HPP
@@ -29,6 +29,11 @@
 #define INCLUDE_TMS9918A_HPP
 
 #include <string.h>
+#ifdef TMS9918A_PROFILE
+#include <chrono>
+#endif
+#include "arena.hpp"
+#include "spsc.hpp"
 
 #define TMS9918A_SCREEN_WIDTH 284
 #define TMS9918A_SCREEN_HEIGHT 240
@@ -66,20 +71,33 @@ class TMS9918A
         RGB555,
         RGB565,
         RGB565_Swap,
+        RGB222,      // 8bpp: 0b00BBGGRR (same bit layout as the FabGL 64 colors controller)
+        RGB222_Swap, // 8bpp: RGB222 stored in the pixel order of the FabGL line buffer (x ^ 2)
+        Indexed4,    // 4bpp: palette index, 2 pixels per byte (high nibble is the left pixel)
     };
 
-  private:
-    void* arg;
-    void (*detectBlank)(void* arg);
-    void (*detectBreak)(void* arg);
-    void (*displayCallback)(void* arg, int frame, int line, unsigned short* display);
+    // Destination of the rendered scanlines (e.g. the line buffers of the VGA controller)
+    struct DisplaySink {
+        void* arg;
+        void* (*getLine)(void* arg, int frame, int line);                // returns the 256 pixels destination of the line (nullptr: not rendered)
+        void (*lineRendered)(void* arg, int frame, int line, void* dst); // notifies the line has been rendered (optional)
+    };
 
-  public:
-    unsigned short* display;
-    size_t displaySize;
-    bool displayNeedFree;
-    unsigned short palette[16];
-    const unsigned int rgb888[16] = {0x000000, 0x000000, 0x3EB849, 0x74D07D, 0x5955E0, 0x8076F1, 0xB95E51, 0x65DBEF, 0xDB6559, 0xFF897D, 0xCCC35E, 0xDED087, 0x3AA241, 0xB766B5, 0xCCCCCC, 0xFFFFFF};
+    // port access recorded for a renderer VDP running on another thread (see setPortLog and replayPortLog)
+    enum class PortEventType : unsigned char {
+        WriteData,
+        WriteAddress,
+        ReadData,
+        ReadStatus,
+        EndOfFrame,
+    };
+    struct PortEvent {
+        PortEventType type;
+        unsigned char value;
+        unsigned char line; // number of the lines rendered in the frame before the access (0..192)
+        unsigned char reserved;
+    };
+    typedef SPSCRing<PortEvent, 4096> PortLog;
 
     typedef struct Context_ {
         int bobo;
@@ -99,7 +117,61 @@ class TMS9918A
         unsigned char reserved8[1];
     } Context;
     Context* ctx;
+
+  private:
+    // the fields touched by every tick and port access lead the object (the buffers and tables follow)
+    PortLog* portLog;
+    bool batchRendering;
+    int batchNext; // next line to be rendered
+    int batchEnd;  // the lines before it have been scanned
+    void* arg;
+    void (*detectBlank)(void* arg);
+    void (*detectBreak)(void* arg);
+    void (*displayCallback)(void* arg, int frame, int line, void* display);
+
+  public:
+    void* display;
+    size_t displaySize;
+    int displayPitch;       // bytes per line
+    int displayBufferLines; // lines held by the display buffer
+    bool displayNeedFree;
+    void* displayLines[192];
+    DisplaySink sink;
+
+    struct RenderStats {
+        unsigned int renderedLines; // lines rendered and output to the destination
+        unsigned int skippedLines;  // lines skipped because their inputs did not change since they were last output
+    } renderStats;
+#ifdef TMS9918A_PROFILE
+    unsigned long long renderNanos; // spent on rendering the lines (timed per batch, or per line without the batch rendering)
+#endif
+
+    // adaptive frame skip: renders 1 of every (skip + 1) frames, where skip (0..maxSkip) follows the measured frame time
+    struct FrameSkip {
+        int maxSkip;                     // 0: render every frame
+        unsigned int budgetMicros;       // wall time budget of an emulated frame
+        int skip;                        // current number of frames skipped after each rendered frame
+        int countdown;                   // frames to skip before the next rendered frame
+        int overFrames;                  // consecutive frames over the budget
+        int underFrames;                 // consecutive frames well under the budget
+        unsigned int lastFrameMicros;    // wall time of the last emulated frame
+        unsigned int averageFrameMicros; // moving average (1/8) of the wall time of the emulated frames
+        unsigned int renderedFrames;
+        unsigned int skippedFrames;
+        unsigned int increases; // times the skip has been increased
+        unsigned int decreases; // times the skip has been decreased
+    } frameSkip;
+    bool frameRendering; // whether the current frame is output (sprites and status are emulated regardless)
+    ColorMode colorMode;
+    unsigned short palette[16];
+    static inline const unsigned int* rgb888()
+    {
+        static const unsigned int table[16] = {0x000000, 0x000000, 0x3EB849, 0x74D07D, 0x5955E0, 0x8076F1, 0xB95E51, 0x65DBEF, 0xDB6559, 0xFF897D, 0xCCC35E, 0xDED087, 0x3AA241, 0xB766B5, 0xCCCCCC, 0xFFFFFF};
+        return table;
+    }
+
     bool ctxNeedFree;
+    Arena* arena; // buffers are allocated from the heap if nullptr
 
     unsigned short swap16(unsigned short src)
     {
@@ -107,73 +179,339 @@ class TMS9918A
         return ((src & 0x00FF) << 8) | work;
     }
 
-    void initialize(ColorMode colorMode, void* arg, void (*detectBlank)(void*), void (*detectBreak)(void*), void (*displayCallback)(void*, int, int, unsigned short*) = nullptr, Context* vram = nullptr)
+    // make the raw pixel values of the 16 colors in a color mode (e.g. to convert the Indexed4 lines at output time)
+    void makePalette(ColorMode colorMode, unsigned short* palette)
     {
-        this->arg = arg;
-        this->detectBlank = detectBlank;
-        this->detectBreak = detectBreak;
-        this->displayCallback = displayCallback;
-        this->displaySize = (this->displayCallback ? 256 : 256 * 192) << 1;
-        this->display = (unsigned short*)malloc(this->displaySize);
-        this->displayNeedFree = true;
-        this->ctx = vram ? vram : (Context*)malloc(sizeof(Context));
-        this->ctxNeedFree = vram ? false : true;
-        memset(this->ctx, 0, sizeof(Context));
-
         switch (colorMode) {
             case ColorMode::RGB555:
                 for (int i = 0; i < 16; i++) {
-                    this->palette[i] = 0;
-                    this->palette[i] |= (this->rgb888[i] & 0b111110000000000000000000) >> 9;
-                    this->palette[i] |= (this->rgb888[i] & 0b000000001111100000000000) >> 6;
-                    this->palette[i] |= (this->rgb888[i] & 0b000000000000000011111000) >> 3;
+                    palette[i] = 0;
+                    palette[i] |= (rgb888()[i] & 0b111110000000000000000000) >> 9;
+                    palette[i] |= (rgb888()[i] & 0b000000001111100000000000) >> 6;
+                    palette[i] |= (rgb888()[i] & 0b000000000000000011111000) >> 3;
                 }
                 break;
             case ColorMode::RGB565:
                 for (int i = 0; i < 16; i++) {
-                    this->palette[i] = 0;
-                    this->palette[i] |= (this->rgb888[i] & 0b111110000000000000000000) >> 8;
-                    this->palette[i] |= (this->rgb888[i] & 0b000000001111110000000000) >> 5;
-                    this->palette[i] |= (this->rgb888[i] & 0b000000000000000011111000) >> 3;
+                    palette[i] = 0;
+                    palette[i] |= (rgb888()[i] & 0b111110000000000000000000) >> 8;
+                    palette[i] |= (rgb888()[i] & 0b000000001111110000000000) >> 5;
+                    palette[i] |= (rgb888()[i] & 0b000000000000000011111000) >> 3;
                 }
                 break;
             case ColorMode::RGB565_Swap:
                 for (int i = 0; i < 16; i++) {
-                    this->palette[i] = 0;
-                    this->palette[i] |= (this->rgb888[i] & 0b111110000000000000000000) >> 8;
-                    this->palette[i] |= (this->rgb888[i] & 0b000000001111110000000000) >> 5;
-                    this->palette[i] |= (this->rgb888[i] & 0b000000000000000011111000) >> 3;
-                    this->palette[i] = swap16(this->palette[i]);
+                    palette[i] = 0;
+                    palette[i] |= (rgb888()[i] & 0b111110000000000000000000) >> 8;
+                    palette[i] |= (rgb888()[i] & 0b000000001111110000000000) >> 5;
+                    palette[i] |= (rgb888()[i] & 0b000000000000000011111000) >> 3;
+                    palette[i] = this->swap16(palette[i]);
+                }
+                break;
+            case ColorMode::RGB222:
+            case ColorMode::RGB222_Swap:
+                for (int i = 0; i < 16; i++) {
+                    palette[i] = 0;
+                    palette[i] |= (rgb888()[i] & 0b110000000000000000000000) >> 22;
+                    palette[i] |= (rgb888()[i] & 0b000000001100000000000000) >> 12;
+                    palette[i] |= (rgb888()[i] & 0b000000000000000011000000) >> 2;
+                }
+                break;
+            case ColorMode::Indexed4:
+                for (int i = 0; i < 16; i++) {
+                    palette[i] = i;
                 }
                 break;
             default:
-                memset(this->palette, 0, sizeof(this->palette));
+                memset(palette, 0, sizeof(unsigned short) * 16);
         }
+    }
+
+    // bufferLines: lines held by the display buffer (192: whole frame, 1 ~ 191: ring of the latest lines, 0: no buffer)
+    void initialize(ColorMode colorMode, void* arg, void (*detectBlank)(void*), void (*detectBreak)(void*), void (*displayCallback)(void*, int, int, void*) = nullptr, Context* vram = nullptr, int bufferLines = 192)
+    {
+        this->arg = arg;
+        this->detectBlank = detectBlank;
+        this->detectBreak = detectBreak;
+        this->displayCallback = displayCallback;
+        this->colorMode = colorMode;
+        switch (colorMode) {
+            case ColorMode::RGB222:
+            case ColorMode::RGB222_Swap: this->displayPitch = 256; break;
+            case ColorMode::Indexed4: this->displayPitch = 128; break;
+            default: this->displayPitch = 256 * 2;
+        }
+        this->dirtyTracking = false;
+        this->ctx = vram ? vram : (Context*)Arena::alloc(this->arena, Arena::Scope::Machine, sizeof(Context));
+        this->ctxNeedFree = vram ? false : true;
+        memset(this->ctx, 0, sizeof(Context));
+
+        this->makePalette(colorMode, this->palette);
+#ifdef TMS9918A_MODE2_TILE_CACHE
+        this->tilePattern = (unsigned char*)Arena::alloc(this->arena, Arena::Scope::Machine, 768 * 8);
+        this->tileColor = (DecodedTile*)Arena::alloc(this->arena, Arena::Scope::Machine, 768 * 8 * sizeof(DecodedTile));
+#endif
+        // allocated last, so that the arena can reclaim it if it is replaced (e.g. useOwnDisplayBuffer)
+        this->displayBufferLines = this->displayCallback ? 1 : (192 < bufferLines ? 192 : bufferLines);
+        this->displaySize = this->displayPitch * this->displayBufferLines;
+        this->display = this->displaySize ? Arena::alloc(this->arena, Arena::Scope::Machine, this->displaySize) : nullptr;
+        this->displayNeedFree = this->display ? true : false;
+        memset(&this->sink, 0, sizeof(this->sink));
+        this->setupDisplayLines();
+        this->setFrameSkip(0);
+        this->batchRendering = false;
+        this->batchNext = 0;
+        this->batchEnd = 0;
+        this->portLog = nullptr;
+        this->replayLine = 0;
+#ifdef TMS9918A_PROFILE
+        this->renderNanos = 0;
+#endif
         this->initRedneringLineTable();
         this->reset();
     }
 
+    TMS9918A()
+    {
+        this->arena = nullptr;
+        this->dirtyTracking = false;
+        memset(this->lineDirty, 1, sizeof(this->lineDirty));
+        memset(this->lineSprites, 0, sizeof(this->lineSprites));
+        memset(this->lineSpriteGeneration, 0, sizeof(this->lineSpriteGeneration));
+        this->spriteGeneration = 0;
+    }
+
     ~TMS9918A()
     {
         this->releaseDisplayBuffer();
+#ifdef TMS9918A_MODE2_TILE_CACHE
+        Arena::free(this->arena, this->tileColor);
+        Arena::free(this->arena, this->tilePattern);
+#endif
         this->releaseContext();
     }
 
-    void useOwnDisplayBuffer(unsigned short* displayBuffer, size_t displayBufferSize)
+    // allocate the buffers from the arena (call before initialize)
+    void setArena(Arena* arena) { this->arena = arena; }
+
+    void useOwnDisplayBuffer(void* displayBuffer, size_t displayBufferSize)
     {
         this->releaseDisplayBuffer();
         this->display = displayBuffer;
         this->displaySize = displayBufferSize;
+        this->displayBufferLines = this->displayCallback ? 1 : (int)(displayBufferSize / this->displayPitch);
+        if (192 < this->displayBufferLines) this->displayBufferLines = 192;
+        this->setupDisplayLines();
+    }
+
+    // Hold only the latest lines in the display buffer (line n is rendered to the slot n % lines).
+    // NOTE: each line must be output (by the display callback or the sink) before it is overwritten.
+    void useLineRing(int lines)
+    {
+        this->releaseDisplayBuffer();
+        this->displayBufferLines = lines < 1 ? 1 : (192 < lines ? 192 : lines);
+        this->displaySize = this->displayPitch * this->displayBufferLines;
+        this->display = Arena::alloc(this->arena, Arena::Scope::Machine, this->displaySize);
+        this->displayNeedFree = true;
+        memset(&this->sink, 0, sizeof(this->sink));
+        this->setupDisplayLines();
+        this->markDirtyAll();
+    }
+
+    // convert the lines rendered in Indexed4 to raw pixels made by makePalette at output time
+    static inline void expandIndexedLine(const void* src, unsigned short* dst, const unsigned short* palette, int count = 256)
+    {
+        const unsigned char* s = (const unsigned char*)src;
+        for (int i = 0; i < count; i += 2, s++) {
+            dst[i] = palette[*s >> 4];
+            dst[i + 1] = palette[*s & 0x0F];
+        }
+    }
+
+    static inline void expandIndexedLine(const void* src, unsigned char* dst, const unsigned short* palette, int count = 256)
+    {
+        const unsigned char* s = (const unsigned char*)src;
+        for (int i = 0; i < count; i += 2, s++) {
+            dst[i] = (unsigned char)palette[*s >> 4];
+            dst[i + 1] = (unsigned char)palette[*s & 0x0F];
+        }
+    }
+
+    struct Footprint {
+        size_t context;   // VRAM and registers allocated by initialize (0: given by the caller)
+        size_t display;   // display buffer allocated by the VDP
+        size_t tileCache; // decoded Mode 2 tiles (TMS9918A_MODE2_TILE_CACHE)
+        size_t total;
+        size_t saved; // compared with a 256x192 16bpp frame buffer
+    };
+
+    Footprint getFootprint()
+    {
+        Footprint fp;
+        fp.context = this->ctxNeedFree ? sizeof(Context) : 0;
+        fp.display = this->displayNeedFree ? this->displaySize : 0;
+#ifdef TMS9918A_MODE2_TILE_CACHE
+        fp.tileCache = 768 * 8 * (1 + sizeof(DecodedTile));
+#else
+        fp.tileCache = 0;
+#endif
+        fp.total = fp.context + fp.display + fp.tileCache;
+        fp.saved = 256 * 192 * 2 - fp.display;
+        return fp;
+    }
+
+    // render each line in place to lines[n] (n = 0 ~ 191) instead of the display buffer
+    void useOwnDisplayLines(void* const* lines)
+    {
+        this->releaseDisplayBuffer();
+        this->display = nullptr;
+        this->displaySize = 0;
+        memset(&this->sink, 0, sizeof(this->sink));
+        memcpy(this->displayLines, lines, sizeof(this->displayLines));
+        this->markDirtyAll();
+    }
+
+    // render each line in place to the destination requested from the sink
+    void useDisplaySink(const DisplaySink& displaySink)
+    {
+        this->releaseDisplayBuffer();
+        this->display = nullptr;
+        this->displaySize = 0;
+        this->sink = displaySink;
+        this->markDirtyAll();
+    }
+
+    // Skip rendering and output of the lines whose inputs (VRAM, registers and sprites) did not change since they were last output.
+    // NOTE: enable it only when the destination of each line keeps its pixels between frames.
+    void setDirtyTracking(bool enabled)
+    {
+        this->dirtyTracking = enabled;
+        this->markDirtyAll();
+    }
+
+    // Defer the rendering of the scanlines until the video memory, a register or the status is accessed, or the active display ends.
+    // A frame without mid-frame accesses is rendered in one pass at the end of the active display.
+    void setBatchRendering(bool enabled)
+    {
+        this->flushBatch();
+        this->batchRendering = enabled;
+        this->batchNext = 0;
+        this->batchEnd = 0;
+    }
+
+    // Record the port accesses to the log for a renderer VDP (the producer side of a split between threads).
+    // This VDP keeps emulating the timing, the sprites and the status, but it does not output the pixels anymore.
+    // NOTE: copy the context to the renderer with syncContext before starting it.
+    void setPortLog(PortLog* log)
+    {
+        this->portLog = log;
+        if (log) {
+            void* lines[192];
+            memset(lines, 0, sizeof(lines));
+            this->useOwnDisplayLines(lines);
+        }
+    }
+
+    // Renderer side: copy the context of the emulating VDP (call it while both of them are stopped)
+    void syncContext(const Context* src)
+    {
+        memcpy(this->ctx, src, sizeof(Context));
+        this->replayLine = 0;
+        this->refresh();
+    }
+
+    // Renderer side: apply the logged port accesses and render the lines scanned before each of them.
+    // Returns the number of the consumed events (0: the log is empty).
+    int replayPortLog(PortLog* log)
+    {
+        int count = 0;
+        const PortEvent* e;
+        while (nullptr != (e = log->peek())) {
+            if (PortEventType::EndOfFrame == e->type) {
+                while (this->replayLine < 192) this->renderScanline(this->replayLine++);
+                this->replayLine = 0;
+                this->ctx->frame++;
+                this->ctx->frame &= 0xFFFF;
+                this->startFrame();
+            } else {
+                while (this->replayLine < e->line) this->renderScanline(this->replayLine++);
+                switch (e->type) {
+                    case PortEventType::WriteData: this->writeData(e->value); break;
+                    case PortEventType::WriteAddress: this->writeAddress(e->value); break;
+                    case PortEventType::ReadData: this->readData(); break;
+                    default: this->readStatus();
+                }
+            }
+            log->drop();
+            count++;
+        }
+        return count;
+    }
+
+    // overwrite a palette entry with a raw pixel value of the current color mode (e.g. to add the sync bits of FabGL)
+    void setPalette(int index, unsigned short value)
+    {
+        this->palette[index & 0x0F] = value;
+        this->acUpdate(7);
+        this->invalidateTileCache();
+        this->markDirtyAll();
+    }
+
+    // enable the adaptive frame skip (maxSkip = 0: disable) that is fed by updateFrameSkip
+    void setFrameSkip(int maxSkip, unsigned int budgetMicros = 16683)
+    {
+        memset(&this->frameSkip, 0, sizeof(this->frameSkip));
+        this->frameSkip.maxSkip = 0 < maxSkip ? maxSkip : 0;
+        this->frameSkip.budgetMicros = budgetMicros;
+        this->frameSkip.averageFrameMicros = budgetMicros / 2;
+        this->frameRendering = true;
+    }
+
+    // report the wall time spent to emulate a frame: the skip goes up quickly while the frames are over the budget,
+    // and comes down slowly while the time predicted with one skip less is under 3/4 of it (hysteresis)
+    void updateFrameSkip(unsigned int frameMicros)
+    {
+        FrameSkip* fs = &this->frameSkip;
+        fs->lastFrameMicros = frameMicros;
+        fs->averageFrameMicros = (fs->averageFrameMicros * 7 + frameMicros) / 8;
+        // the average is amortized over the skipped frames (1 of skip + 1 frames is rendered)
+        unsigned int lessSkipMicros = 0 < fs->skip ? fs->averageFrameMicros * (fs->skip + 1) / fs->skip : fs->averageFrameMicros;
+        if (fs->budgetMicros < fs->averageFrameMicros) {
+            fs->underFrames = 0;
+            if (8 <= ++fs->overFrames && fs->skip < fs->maxSkip) {
+                fs->skip++;
+                fs->increases++;
+                fs->overFrames = 0;
+            }
+        } else if (lessSkipMicros < fs->budgetMicros * 3 / 4) {
+            fs->overFrames = 0;
+            if (60 <= ++fs->underFrames && 0 < fs->skip) {
+                fs->skip--;
+                fs->decreases++;
+                fs->underFrames = 0;
+            }
+        } else {
+            fs->overFrames = 0;
+            fs->underFrames = 0;
+        }
     }
 
     void reset()
     {
-        memset(this->display, 0, this->displaySize);
+        if (this->display) memset(this->display, 0, this->displaySize);
         memset(this->ctx, 0, sizeof(Context));
+        memset(&this->renderStats, 0, sizeof(this->renderStats));
+        this->setFrameSkip(this->frameSkip.maxSkip, this->frameSkip.budgetMicros);
         this->refresh();
     }
 
-    void refresh() { this->acUpdate(); }
+    void refresh()
+    {
+        this->batchNext = 0;
+        this->batchEnd = 0;
+        this->acUpdate();
+        this->markDirtyAll();
+    }
     inline bool isEnabledScreen() { return ac.isEnabledScreen; }
     inline bool isEnabledInterrupt() { return ac.isEnabledInterrupt; }
     inline unsigned short getBackdropColor() { return ac.backdropColor; }
@@ -186,7 +524,18 @@ class TMS9918A
             // render backdrop border
             if (this->ctx->isRenderingLine) {
                 if (24 + TMS9918A_SCREEN_WIDTH == this->ctx->countH) {
-                    this->renderScanline(this->ctx->countV - 27);
+                    if (this->batchRendering) {
+                        this->batchEnd = this->ctx->countV - 26;
+                        if (192 == this->batchEnd) this->flushBatch();
+                    } else {
+#ifdef TMS9918A_PROFILE
+                        long long renderStart = this->profileNanos();
+#endif
+                        this->renderScanline(this->ctx->countV - 27);
+#ifdef TMS9918A_PROFILE
+                        this->renderNanos += this->profileNanos() - renderStart;
+#endif
+                    }
                 }
             }
             // sync blank or end-of-frame
@@ -204,6 +553,8 @@ class TMS9918A
                     this->detectBreak(this->arg);
                     this->ctx->frame++;
                     this->ctx->frame &= 0xFFFF;
+                    if (this->portLog) this->logPortEvent(PortEventType::EndOfFrame, 0);
+                    this->startFrame();
                 }
             }
         }
@@ -211,6 +562,7 @@ class TMS9918A
 
     inline unsigned char readData()
     {
+        if (this->portLog) this->logPortEvent(PortEventType::ReadData, 0);
         unsigned char result = this->ctx->readBuffer;
         this->readVideoMemory();
         this->ctx->latch = 0;
@@ -219,6 +571,8 @@ class TMS9918A
 
     inline unsigned char readStatus()
     {
+        this->flushBatch(); // the sprite status of the pending lines
+        if (this->portLog) this->logPortEvent(PortEventType::ReadStatus, 0);
         unsigned char result = this->ctx->stat;
         this->ctx->stat &= 0b01011111;
         this->ctx->latch = 0;
@@ -227,15 +581,26 @@ class TMS9918A
 
     inline void writeData(unsigned char value)
     {
+        this->flushBatch();
+        if (this->portLog) this->logPortEvent(PortEventType::WriteData, value);
         this->ctx->addr &= 0x3FFF;
         this->ctx->readBuffer = value;
         this->ctx->writeAddr = this->ctx->addr++;
         this->ctx->ram[this->ctx->writeAddr] = this->ctx->readBuffer;
         this->ctx->latch = 0;
+        if (this->dirtyTracking) {
+            this->markDirtyVideoMemory(this->ctx->writeAddr);
+        }
+#ifdef TMS9918A_MODE2_TILE_CACHE
+        if (this->tileCacheValid) {
+            this->updateTileCache(this->ctx->writeAddr);
+        }
+#endif
     }
 
     inline void writeAddress(unsigned char value)
     {
+        if (this->portLog) this->logPortEvent(PortEventType::WriteAddress, value);
         this->ctx->latch &= 1;
         this->ctx->tmpAddr[this->ctx->latch++] = value;
         if (2 == this->ctx->latch) {
@@ -275,16 +640,20 @@ class TMS9918A
         int bd;
     } ac;
 
+    // 0: Graphic 1, 1: Text 1, 2: Graphic 2, 3: Multicolor
+    // 4: Text 1 with the Graphic 2 pattern table (M1+M2)
+    // 5: Multicolor with the Graphic 2 pattern table (M2+M3)
+    // 6: 40 columns of 4 foreground + 2 background pixels (M1+M3, M1+M2+M3)
     inline void acUpdateMode()
     {
-        if (this->ctx->reg[1] & 0b00010000) {
-            this->ac.mode = 1;
-        } else if (this->ctx->reg[0] & 0b00000010) {
-            this->ac.mode = 2;
-        } else if (this->ctx->reg[1] & 0b00001000) {
-            this->ac.mode = 3;
-        } else {
-            this->ac.mode = 0;
+        static const unsigned char modeTable[8] = {0, 1, 2, 4, 3, 6, 5, 6};
+        int m = 0;
+        if (this->ctx->reg[1] & 0b00010000) m |= 1; // M1
+        if (this->ctx->reg[0] & 0b00000010) m |= 2; // M2
+        if (this->ctx->reg[1] & 0b00001000) m |= 4; // M3
+        this->ac.mode = modeTable[m];
+        if (2 != this->ac.mode) {
+            this->invalidateTileCache(); // the cache is not updated while the other modes are used
         }
     }
 
@@ -316,6 +685,7 @@ class TMS9918A
         tms->ac.cmask = tms->ctx->reg[3] & 0b01111111;
         tms->ac.cmask <<= 3;
         tms->ac.cmask |= 0x07;
+        tms->invalidateTileCache();
     }
 
     static inline void acUpdate4(TMS9918A* tms)
@@ -325,6 +695,7 @@ class TMS9918A
         tms->ac.pmask = tms->ctx->reg[4] & 0b00000011;
         tms->ac.pmask <<= 8;
         tms->ac.pmask |= 0xFF;
+        tms->invalidateTileCache();
     }
 
     static inline void acUpdate5(TMS9918A* tms)
@@ -341,10 +712,15 @@ class TMS9918A
     {
         tms->ac.bd = tms->ctx->reg[7] & 0b00001111;
         tms->ac.backdropColor = tms->palette[tms->ac.bd];
+        tms->invalidateTileCache();
     }
 
-    void (*updateTable[8])(TMS9918A*) = {acUpdate0, acUpdate1, acUpdate2, acUpdate3, acUpdate4, acUpdate5, acUpdate6, acUpdate7};
-    inline void acUpdate(int n) { updateTable[n & 7](this); }
+    static inline void (*const* updateTable())(TMS9918A*)
+    {
+        static void (*const table[8])(TMS9918A*) = {acUpdate0, acUpdate1, acUpdate2, acUpdate3, acUpdate4, acUpdate5, acUpdate6, acUpdate7};
+        return table;
+    }
+    inline void acUpdate(int n) { updateTable()[n & 7](this); }
     inline void acUpdate()
     {
         for (int i = 0; i < 8; i++) acUpdate(i);
@@ -365,7 +741,7 @@ class TMS9918A
     void releaseDisplayBuffer()
     {
         if (this->displayNeedFree) {
-            free(this->display);
+            Arena::free(this->arena, this->display);
             this->display = nullptr;
             this->displaySize = 0;
             this->displayNeedFree = false;
@@ -375,52 +751,213 @@ class TMS9918A
     void releaseContext()
     {
         if (this->ctxNeedFree) {
-            free(this->ctx);
+            Arena::free(this->arena, this->ctx);
             this->ctx = nullptr;
             this->ctxNeedFree = false;
         }
     }
 
-    inline void renderScanline(int lineNumber)
+    int replayLine; // next line to be rendered by replayPortLog
+
+    inline void logPortEvent(PortEventType type, unsigned char value)
     {
-#ifdef TMS9918A_SKIP_ODD_FRAME_RENDERING
-        bool isEvenFrame = 0 == (this->ctx->frame & 1);
+        PortEvent e;
+        e.type = type;
+        e.value = value;
+        if (this->ctx->countV < 27) {
+            e.line = 0;
+        } else if (27 + 192 <= this->ctx->countV) {
+            e.line = 192;
+        } else {
+            e.line = this->ctx->countV - 27 + (24 + TMS9918A_SCREEN_WIDTH <= this->ctx->countH ? 1 : 0);
+        }
+        e.reserved = 0;
+        this->portLog->pushWait(e);
+    }
+
+    inline void flushBatch()
+    {
+        if (this->batchNext < this->batchEnd) {
+#ifdef TMS9918A_PROFILE
+            long long renderStart = this->profileNanos();
 #endif
-        // TODO: Several modes (1, 3, undocumented) are not implemented
-        if (this->isEnabledScreen()) {
-            switch (this->ac.mode) {
-#ifdef TMS9918A_SKIP_ODD_FRAME_RENDERING
-                case 0: this->renderScanlineMode0(lineNumber, isEvenFrame); break;
-                case 2: this->renderScanlineMode2(lineNumber, isEvenFrame); break;
-#else
-                case 0: this->renderScanlineMode0(lineNumber); break;
-                case 2: this->renderScanlineMode2(lineNumber); break;
+            do {
+                this->renderScanline(this->batchNext++);
+            } while (this->batchNext < this->batchEnd);
+#ifdef TMS9918A_PROFILE
+            this->renderNanos += this->profileNanos() - renderStart;
 #endif
+            if (192 == this->batchNext) {
+                this->batchNext = 0;
+                this->batchEnd = 0;
             }
-        } else {
-#ifdef TMS9918A_SKIP_ODD_FRAME_RENDERING
-            if (isEvenFrame) {
-                int dcur = this->getDisplayPtr(lineNumber);
-                for (int i = 0; i < 256; i++) {
-                    this->display[dcur++] = this->ac.backdropColor;
-                }
-            }
-#else
-            int dcur = this->getDisplayPtr(lineNumber);
-            for (int i = 0; i < 256; i++) {
-                this->display[dcur++] = this->ac.backdropColor;
-            }
+        }
+    }
+
+#ifdef TMS9918A_PROFILE
+    static inline long long profileNanos()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 #endif
+
+    inline void startFrame()
+    {
+        if (0 < this->frameSkip.countdown) {
+            this->frameSkip.countdown--;
+            this->frameSkip.skippedFrames++;
+            this->frameRendering = false;
+        } else {
+            this->frameSkip.countdown = this->frameSkip.skip;
+            this->frameSkip.renderedFrames++;
+            this->frameRendering = true;
         }
-#ifdef TMS9918A_SKIP_ODD_FRAME_RENDERING
-        if (this->displayCallback && isEvenFrame) {
-            this->displayCallback(this->arg, this->ctx->frame, lineNumber, this->display);
+    }
+
+    inline void renderScanline(int lineNumber)
+    {
+        bool rendering = this->frameRendering;
+        unsigned char dlog[256];
+        bool sprites = false;
+        if (this->isEnabledScreen() && this->isSpriteMode()) {
+            sprites = this->renderSprites(lineNumber, dlog);
+        }
+        if (rendering && this->dirtyTracking && !this->isChangedLine(lineNumber, sprites)) {
+            this->renderStats.skippedLines++;
+            return;
+        }
+        void* line = rendering ? this->getDisplayLine(lineNumber) : nullptr;
+        if (!line) return;
+        switch (this->colorMode) {
+            case ColorMode::RGB222: this->renderScanline((Pixel8*)line, lineNumber, dlog, sprites); break;
+            case ColorMode::RGB222_Swap: this->renderScanline((Pixel8Swap*)line, lineNumber, dlog, sprites); break;
+            case ColorMode::Indexed4: this->renderScanline((Pixel4*)line, lineNumber, dlog, sprites); break;
+            default: this->renderScanline((Pixel16*)line, lineNumber, dlog, sprites); break;
+        }
+        this->lineDirty[lineNumber] = 0;
+        this->lineSprites[lineNumber] = sprites;
+        this->lineSpriteGeneration[lineNumber] = this->spriteGeneration;
+        this->renderStats.renderedLines++;
+        if (this->sink.lineRendered) {
+            this->sink.lineRendered(this->sink.arg, this->ctx->frame, lineNumber, line);
         }
-#else
         if (this->displayCallback) {
-            this->displayCallback(this->arg, this->ctx->frame, lineNumber, this->display);
+            this->displayCallback(this->arg, this->ctx->frame, lineNumber, line);
+        }
+    }
+
+    template <typename T>
+    inline void renderScanline(T* line, int lineNumber, const unsigned char* dlog, bool sprites)
+    {
+        if (this->isEnabledScreen()) {
+            switch (this->ac.mode) {
+                case 0: this->renderScanlineMode0(line, lineNumber); break;
+                case 1: this->renderScanlineMode1(line, lineNumber, ac.pg0, 0, 0xFF); break;
+                case 2: this->renderScanlineMode2(line, lineNumber); break;
+                case 3: this->renderScanlineMode3(line, lineNumber, ac.pg0, 0, 0xFF); break;
+                case 4: this->renderScanlineMode1(line, lineNumber, ac.pg2, (lineNumber / 64) * 256, ac.pmask); break;
+                case 5: this->renderScanlineMode3(line, lineNumber, ac.pg2, (lineNumber / 64) * 256, ac.pmask); break;
+                case 6: this->renderScanlineMode6(line); break;
+            }
+            if (sprites) this->putSprites(line, dlog);
+        } else {
+            fillPixels(line, 256, this->ac.backdropColor);
+        }
+    }
+
+    bool dirtyTracking;
+    unsigned char lineDirty[192];
+    unsigned char lineSprites[192];
+    unsigned int lineSpriteGeneration[192];
+    unsigned int spriteGeneration;
+
+    inline bool isSpriteMode()
+    {
+        switch (this->ac.mode) {
+            case 0:
+            case 2:
+            case 3:
+            case 5: return true;
+            default: return false;
+        }
+    }
+
+    inline bool isChangedLine(int lineNumber, bool sprites)
+    {
+        if (this->lineDirty[lineNumber]) return true;
+        if (this->lineSpriteGeneration[lineNumber] == this->spriteGeneration) return false;
+        return sprites || this->lineSprites[lineNumber];
+    }
+
+    inline void markDirtyAll()
+    {
+        memset(this->lineDirty, 1, sizeof(this->lineDirty));
+        this->spriteGeneration++;
+    }
+
+    inline void markDirtyRow(int row)
+    {
+        if (row < 24) memset(&this->lineDirty[row * 8], 1, 8);
+    }
+
+    inline void markDirtyPixelLine(int pixelLine)
+    {
+        for (int i = pixelLine & 7; i < 192; i += 8) this->lineDirty[i] = 1;
+    }
+
+    // a multicolor pattern byte covers 4 lines of every 4th row
+    inline void markDirtyMulticolorLine(int pixelLine)
+    {
+        for (int row = (pixelLine & 7) / 2; row < 24; row += 4) {
+            memset(&this->lineDirty[row * 8 + (pixelLine & 1) * 4], 1, 4);
+        }
+    }
+
+    inline void markDirtyVideoMemory(int addr)
+    {
+        if ((unsigned int)(addr - this->ac.sa) < 128 || (unsigned int)(addr - this->ac.sg) < 2048) {
+            this->spriteGeneration++;
+        }
+        unsigned int off;
+        switch (this->ac.mode) {
+            case 0:
+                if ((off = addr - this->ac.pn) < 768) this->markDirtyRow(off / 32);
+                if ((off = addr - this->ac.pg0) < 2048) this->markDirtyPixelLine(off);
+                if ((off = addr - this->ac.ct0) < 32) this->markDirtyAll();
+                break;
+            case 1:
+                if ((off = addr - this->ac.pn) < 960) this->markDirtyRow(off / 40);
+                if ((off = addr - this->ac.pg0) < 2048) this->markDirtyPixelLine(off);
+                break;
+            case 2:
+                if ((off = addr - this->ac.pn) < 768) this->markDirtyRow(off / 32);
+                if ((off = addr - this->ac.pg2) < 0x1800) this->markDirtyPixelLine(off);
+                if ((off = addr - this->ac.ct2) < 0x1800) this->markDirtyPixelLine(off);
+                break;
+            case 3:
+                if ((off = addr - this->ac.pn) < 768) this->markDirtyRow(off / 32);
+                if ((off = addr - this->ac.pg0) < 2048) this->markDirtyMulticolorLine(off);
+                break;
+            case 4:
+                if ((off = addr - this->ac.pn) < 960) this->markDirtyRow(off / 40);
+                if ((off = addr - this->ac.pg2) < 0x1800) this->markDirtyPixelLine(off);
+                break;
+            case 5:
+                if ((off = addr - this->ac.pn) < 768) this->markDirtyRow(off / 32);
+                if ((off = addr - this->ac.pg2) < 0x1800) this->markDirtyMulticolorLine(off);
+                break;
+            default:
+                break; // mode 6 does not refer the video memory
+        }
+    }
+
+    inline void markDirtyRegister(int r)
+    {
+        switch (r) {
+            case 5:
+            case 6: this->spriteGeneration++; break;
+            default: this->markDirtyAll();
         }
-#endif
     }
 
     inline void updateAddress()
@@ -440,81 +977,311 @@ class TMS9918A
     inline void updateRegister()
     {
         bool previousInterrupt = this->isEnabledInterrupt();
-        int r = this->ctx->tmpAddr[1] & 0b00001111;
-        this->ctx->reg[r] = this->ctx->tmpAddr[0];
-        this->acUpdate(r);
+        int r = this->ctx->tmpAddr[1] & 0b00000111; // TMS9918A decodes 3 bits (R#8-15 mirror R#0-7)
+        if (this->ctx->reg[r] != this->ctx->tmpAddr[0]) {
+            this->flushBatch();
+            if (this->dirtyTracking) {
+                this->markDirtyRegister(r);
+            }
+            this->ctx->reg[r] = this->ctx->tmpAddr[0];
+            this->acUpdate(r);
+        }
         if (!previousInterrupt && this->isEnabledInterrupt() && this->ctx->stat & 0x80) {
             this->detectBlank(this->arg);
         }
     }
 
-    inline int getDisplayPtr(int lineNumber)
-    {
-        return this->displayCallback ? 0 : lineNumber * 256;
-    }
-
-    inline void renderScanlineMode0(int lineNumber, bool rendering = true)
-    {
-        int dcur = this->getDisplayPtr(lineNumber);
-        int dcur0 = dcur;
-        if (rendering) {
-            int pixelLine = lineNumber % 8;
-            unsigned char* nam = &this->ctx->ram[ac.pn + lineNumber / 8 * 32];
-            int ptn;
-            int c;
-            int cc[2];
-            for (int i = 0; i < 32; i++) {
-                ptn = this->ctx->ram[ac.pg0 + nam[i] * 8 + pixelLine];
-                c = this->ctx->ram[ac.ct0 + nam[i] / 8];
-                cc[1] = (c & 0xF0) >> 4;
-                cc[1] = this->palette[cc[1] ? cc[1] : ac.bd];
-                cc[0] = c & 0x0F;
-                cc[0] = this->palette[cc[0] ? cc[0] : ac.bd];
-                this->display[dcur++] = cc[(ptn & 0b10000000) >> 7];
-                this->display[dcur++] = cc[(ptn & 0b01000000) >> 6];
-                this->display[dcur++] = cc[(ptn & 0b00100000) >> 5];
-                this->display[dcur++] = cc[(ptn & 0b00010000) >> 4];
-                this->display[dcur++] = cc[(ptn & 0b00001000) >> 3];
-                this->display[dcur++] = cc[(ptn & 0b00000100) >> 2];
-                this->display[dcur++] = cc[(ptn & 0b00000010) >> 1];
-                this->display[dcur++] = cc[ptn & 0b00000001];
-            }
+    void setupDisplayLines()
+    {
+        for (int i = 0; i < 192; i++) {
+            this->displayLines[i] = this->display && this->displayBufferLines ? (unsigned char*)this->display + i % this->displayBufferLines * this->displayPitch : nullptr;
         }
-        renderSprites(lineNumber, &display[dcur0], rendering);
-    }
-
-    inline void renderScanlineMode2(int lineNumber, bool rendering = true)
-    {
-        int dcur = this->getDisplayPtr(lineNumber);
-        int dcur0 = dcur;
-        if (rendering) {
-            int pixelLine = lineNumber % 8;
-            unsigned char* nam = &this->ctx->ram[ac.pn + lineNumber / 8 * 32];
-            int ci = (lineNumber / 64) * 256;
-            int ptn;
-            int c;
-            int cc[2];
-            for (int i = 0; i < 32; i++) {
-                ptn = this->ctx->ram[ac.pg2 + ((nam[i] + ci) & ac.pmask) * 8 + pixelLine];
-                c = this->ctx->ram[ac.ct2 + ((nam[i] + ci) & ac.cmask) * 8 + pixelLine];
-                cc[1] = (c & 0xF0) >> 4;
-                cc[1] = this->palette[cc[1] ? cc[1] : ac.bd];
-                cc[0] = c & 0x0F;
-                cc[0] = this->palette[cc[0] ? cc[0] : ac.bd];
-                this->display[dcur++] = cc[(ptn & 0b10000000) >> 7];
-                this->display[dcur++] = cc[(ptn & 0b01000000) >> 6];
-                this->display[dcur++] = cc[(ptn & 0b00100000) >> 5];
-                this->display[dcur++] = cc[(ptn & 0b00010000) >> 4];
-                this->display[dcur++] = cc[(ptn & 0b00001000) >> 3];
-                this->display[dcur++] = cc[(ptn & 0b00000100) >> 2];
-                this->display[dcur++] = cc[(ptn & 0b00000010) >> 1];
-                this->display[dcur++] = cc[ptn & 0b00000001];
+    }
+
+    inline void* getDisplayLine(int lineNumber)
+    {
+        if (this->sink.getLine) {
+            return this->sink.getLine(this->sink.arg, this->ctx->frame, lineNumber);
+        }
+        return this->displayLines[lineNumber];
+    }
+
+    // pixel storage of each color mode (Pixel4 holds 2 pixels)
+    typedef unsigned short Pixel16;
+    typedef unsigned char Pixel8;
+    struct Pixel8Swap {
+        unsigned char value;
+    };
+    struct Pixel4 {
+        unsigned char value;
+    };
+
+    static inline void putPixel(Pixel16* line, int x, unsigned short color) { line[x] = color; }
+    static inline void putPixel(Pixel8* line, int x, unsigned short color) { line[x] = (unsigned char)color; }
+    static inline void putPixel(Pixel8Swap* line, int x, unsigned short color) { line[x ^ 2].value = (unsigned char)color; }
+    static inline void putPixel(Pixel4* line, int x, unsigned short color)
+    {
+        unsigned char* p = &line[x >> 1].value;
+        *p = x & 1 ? (*p & 0xF0) | color : (*p & 0x0F) | (color << 4);
+    }
+
+    static inline void fillPixels(Pixel16* line, int count, unsigned short color)
+    {
+        for (int i = 0; i < count; i++) line[i] = color;
+    }
+    static inline void fillPixels(Pixel8* line, int count, unsigned short color) { memset(line, color, count); }
+    static inline void fillPixels(Pixel8Swap* line, int count, unsigned short color) { memset(line, color, count); }
+    static inline void fillPixels(Pixel4* line, int count, unsigned short color) { memset(line, color * 0x11, count >> 1); }
+
+    // write the 8 pixels of a pattern byte at x (x must be a multiple of 8)
+    static inline void putPattern(Pixel16* line, int x, int ptn, unsigned short fg, unsigned short bg)
+    {
+        unsigned short cc[2] = {bg, fg};
+        line += x;
+        line[0] = cc[(ptn & 0b10000000) >> 7];
+        line[1] = cc[(ptn & 0b01000000) >> 6];
+        line[2] = cc[(ptn & 0b00100000) >> 5];
+        line[3] = cc[(ptn & 0b00010000) >> 4];
+        line[4] = cc[(ptn & 0b00001000) >> 3];
+        line[5] = cc[(ptn & 0b00000100) >> 2];
+        line[6] = cc[(ptn & 0b00000010) >> 1];
+        line[7] = cc[ptn & 0b00000001];
+    }
+
+    static inline void putPattern(Pixel8* line, int x, int ptn, unsigned short fg, unsigned short bg)
+    {
+        unsigned char cc[2] = {(unsigned char)bg, (unsigned char)fg};
+        line += x;
+        line[0] = cc[(ptn & 0b10000000) >> 7];
+        line[1] = cc[(ptn & 0b01000000) >> 6];
+        line[2] = cc[(ptn & 0b00100000) >> 5];
+        line[3] = cc[(ptn & 0b00010000) >> 4];
+        line[4] = cc[(ptn & 0b00001000) >> 3];
+        line[5] = cc[(ptn & 0b00000100) >> 2];
+        line[6] = cc[(ptn & 0b00000010) >> 1];
+        line[7] = cc[ptn & 0b00000001];
+    }
+
+    static inline void putPattern(Pixel8Swap* line, int x, int ptn, unsigned short fg, unsigned short bg)
+    {
+        unsigned char cc[2] = {(unsigned char)bg, (unsigned char)fg};
+        unsigned char* p = &line[x].value;
+        p[2] = cc[(ptn & 0b10000000) >> 7];
+        p[3] = cc[(ptn & 0b01000000) >> 6];
+        p[0] = cc[(ptn & 0b00100000) >> 5];
+        p[1] = cc[(ptn & 0b00010000) >> 4];
+        p[6] = cc[(ptn & 0b00001000) >> 3];
+        p[7] = cc[(ptn & 0b00000100) >> 2];
+        p[4] = cc[(ptn & 0b00000010) >> 1];
+        p[5] = cc[ptn & 0b00000001];
+    }
+
+    static inline void putPattern(Pixel4* line, int x, int ptn, unsigned short fg, unsigned short bg)
+    {
+        unsigned char cc[2] = {(unsigned char)bg, (unsigned char)fg};
+        unsigned char* p = &line[x >> 1].value;
+        p[0] = (cc[(ptn & 0b10000000) >> 7] << 4) | cc[(ptn & 0b01000000) >> 6];
+        p[1] = (cc[(ptn & 0b00100000) >> 5] << 4) | cc[(ptn & 0b00010000) >> 4];
+        p[2] = (cc[(ptn & 0b00001000) >> 3] << 4) | cc[(ptn & 0b00000100) >> 2];
+        p[3] = (cc[(ptn & 0b00000010) >> 1] << 4) | cc[ptn & 0b00000001];
+    }
+
+    // write the 6 pixels of the upper bits of a pattern byte at x (x must be even)
+    template <typename T>
+    static inline void putPattern6(T* line, int x, int ptn, unsigned short fg, unsigned short bg)
+    {
+        unsigned short cc[2] = {bg, fg};
+        putPixel(line, x + 0, cc[(ptn & 0b10000000) >> 7]);
+        putPixel(line, x + 1, cc[(ptn & 0b01000000) >> 6]);
+        putPixel(line, x + 2, cc[(ptn & 0b00100000) >> 5]);
+        putPixel(line, x + 3, cc[(ptn & 0b00010000) >> 4]);
+        putPixel(line, x + 4, cc[(ptn & 0b00001000) >> 3]);
+        putPixel(line, x + 5, cc[(ptn & 0b00000100) >> 2]);
+    }
+
+    static inline void putPattern6(Pixel4* line, int x, int ptn, unsigned short fg, unsigned short bg)
+    {
+        unsigned char cc[2] = {(unsigned char)bg, (unsigned char)fg};
+        unsigned char* p = &line[x >> 1].value;
+        p[0] = (cc[(ptn & 0b10000000) >> 7] << 4) | cc[(ptn & 0b01000000) >> 6];
+        p[1] = (cc[(ptn & 0b00100000) >> 5] << 4) | cc[(ptn & 0b00010000) >> 4];
+        p[2] = (cc[(ptn & 0b00001000) >> 3] << 4) | cc[(ptn & 0b00000100) >> 2];
+    }
+
+    // pointer to the pixel at x (x must be a multiple of 4)
+    template <typename T>
+    static inline T* pixelPointer(T* line, int x) { return line + x; }
+    static inline Pixel4* pixelPointer(Pixel4* line, int x) { return line + (x >> 1); }
+
+    template <typename T>
+    inline void putSprites(T* line, const unsigned char* dlog)
+    {
+        for (int x = 0; x < 256; x++) {
+            if (dlog[x]) putPixel(line, x, this->palette[dlog[x]]);
+        }
+    }
+
+    template <typename T>
+    inline void renderScanlineMode0(T* line, int lineNumber)
+    {
+        int pixelLine = lineNumber % 8;
+        unsigned char* nam = &this->ctx->ram[ac.pn + lineNumber / 8 * 32];
+        int ptn;
+        int c;
+        int fg;
+        int bg;
+        for (int i = 0; i < 32; i++) {
+            ptn = this->ctx->ram[ac.pg0 + nam[i] * 8 + pixelLine];
+            c = this->ctx->ram[ac.ct0 + nam[i] / 8];
+            fg = (c & 0xF0) >> 4;
+            bg = c & 0x0F;
+            putPattern(line, i * 8, ptn, this->palette[fg ? fg : ac.bd], this->palette[bg ? bg : ac.bd]);
+        }
+    }
+
+    // text modes have the 8 pixels border at the both sides of the 40 cells (6 pixels per cell)
+    template <typename T>
+    inline void renderTextBorder(T* line)
+    {
+        fillPixels(line, 8, this->ac.backdropColor);
+        fillPixels(pixelPointer(line, 248), 8, this->ac.backdropColor);
+    }
+
+    template <typename T>
+    inline void renderScanlineMode1(T* line, int lineNumber, int pg, int ci, int pmask)
+    {
+        int pixelLine = lineNumber % 8;
+        unsigned char* nam = &this->ctx->ram[ac.pn + lineNumber / 8 * 40];
+        int fg = (this->ctx->reg[7] & 0xF0) >> 4;
+        unsigned short fc = this->palette[fg ? fg : ac.bd];
+        unsigned short bc = this->ac.backdropColor;
+        this->renderTextBorder(line);
+        for (int i = 0; i < 40; i++) {
+            putPattern6(line, 8 + i * 6, this->ctx->ram[pg + ((nam[i] + ci) & pmask) * 8 + pixelLine], fc, bc);
+        }
+    }
+
+    template <typename T>
+    inline void renderScanlineMode3(T* line, int lineNumber, int pg, int ci, int pmask)
+    {
+        unsigned char* nam = &this->ctx->ram[ac.pn + lineNumber / 8 * 32];
+        int pixelLine = (lineNumber / 8 & 3) * 2 + (lineNumber / 4 & 1);
+        int c;
+        int left;
+        int right;
+        for (int i = 0; i < 32; i++) {
+            c = this->ctx->ram[pg + ((nam[i] + ci) & pmask) * 8 + pixelLine];
+            left = (c & 0xF0) >> 4;
+            right = c & 0x0F;
+            putPattern(line, i * 8, 0xF0, this->palette[left ? left : ac.bd], this->palette[right ? right : ac.bd]);
+        }
+    }
+
+    template <typename T>
+    inline void renderScanlineMode6(T* line)
+    {
+        int fg = (this->ctx->reg[7] & 0xF0) >> 4;
+        unsigned short fc = this->palette[fg ? fg : ac.bd];
+        this->renderTextBorder(line);
+        for (int i = 0; i < 40; i++) {
+            putPattern6(line, 8 + i * 6, 0xF0, fc, this->ac.backdropColor);
+        }
+    }
+
+    template <typename T>
+    inline void renderScanlineMode2(T* line, int lineNumber)
+    {
+        int pixelLine = lineNumber % 8;
+        unsigned char* nam = &this->ctx->ram[ac.pn + lineNumber / 8 * 32];
+        int ci = (lineNumber / 64) * 256;
+#ifdef TMS9918A_MODE2_TILE_CACHE
+        if (!this->tileCacheValid) {
+            this->rebuildTileCache();
+        }
+        const unsigned char* ptn = &this->tilePattern[pixelLine * 768 + ci];
+        const DecodedTile* col = &this->tileColor[pixelLine * 768 + ci];
+        for (int i = 0; i < 32; i++) {
+            putPattern(line, i * 8, ptn[nam[i]], col[nam[i]].fg, col[nam[i]].bg);
+        }
+#else
+        int ptn;
+        int c;
+        int fg;
+        int bg;
+        for (int i = 0; i < 32; i++) {
+            ptn = this->ctx->ram[ac.pg2 + ((nam[i] + ci) & ac.pmask) * 8 + pixelLine];
+            c = this->ctx->ram[ac.ct2 + ((nam[i] + ci) & ac.cmask) * 8 + pixelLine];
+            fg = (c & 0xF0) >> 4;
+            bg = c & 0x0F;
+            putPattern(line, i * 8, ptn, this->palette[fg ? fg : ac.bd], this->palette[bg ? bg : ac.bd]);
+        }
+#endif
+    }
+
+#ifdef TMS9918A_MODE2_TILE_CACHE
+    // Mode 2 tiles decoded per [pixel line][slot] (slot = name + 256 * third of the screen)
+    struct DecodedTile {
+        unsigned short fg;
+        unsigned short bg;
+    };
+    unsigned char* tilePattern;
+    DecodedTile* tileColor;
+    bool tileCacheValid;
+
+    inline void decodeTileColor(DecodedTile* tile, unsigned char c)
+    {
+        int fg = (c & 0xF0) >> 4;
+        int bg = c & 0x0F;
+        tile->fg = this->palette[fg ? fg : ac.bd];
+        tile->bg = this->palette[bg ? bg : ac.bd];
+    }
+
+    void rebuildTileCache()
+    {
+        for (int pixelLine = 0; pixelLine < 8; pixelLine++) {
+            for (int slot = 0; slot < 768; slot++) {
+                this->tilePattern[pixelLine * 768 + slot] = this->ctx->ram[ac.pg2 + (slot & ac.pmask) * 8 + pixelLine];
+                this->decodeTileColor(&this->tileColor[pixelLine * 768 + slot], this->ctx->ram[ac.ct2 + (slot & ac.cmask) * 8 + pixelLine]);
             }
         }
-        renderSprites(lineNumber, &display[dcur0], rendering);
+        this->tileCacheValid = true;
+    }
+
+    // update the slots referring to the written pattern/color (the slots are enumerated by the bits not covered by the mask)
+    inline void updateTileCache(int addr)
+    {
+        unsigned int off = addr - ac.pg2;
+        if (off < 0x2000 && 0 == ((off >> 3) & ~ac.pmask)) {
+            int free = 0x3FF & ~ac.pmask;
+            int sub = 0;
+            do {
+                int slot = (off >> 3) | sub;
+                if (slot < 768) this->tilePattern[(off & 7) * 768 + slot] = this->ctx->ram[addr];
+                sub = (sub - free) & free;
+            } while (sub);
+        }
+        off = addr - ac.ct2;
+        if (off < 0x2000 && 0 == ((off >> 3) & ~ac.cmask)) {
+            int free = 0x3FF & ~ac.cmask;
+            int sub = 0;
+            do {
+                int slot = (off >> 3) | sub;
+                if (slot < 768) this->decodeTileColor(&this->tileColor[(off & 7) * 768 + slot], this->ctx->ram[addr]);
+                sub = (sub - free) & free;
+            } while (sub);
+        }
     }
+#endif
 
-    inline void renderSprites(int lineNumber, unsigned short* renderPosition, bool rendering)
+    inline void invalidateTileCache()
+    {
+#ifdef TMS9918A_MODE2_TILE_CACHE
+        this->tileCacheValid = false;
+#endif
+    }
+
+    // evaluate the sprites of the line: update the status register and store the color of each visible pixel to dlog
+    inline bool renderSprites(int lineNumber, unsigned char* dlog)
     {
         static const unsigned char bit[8] = {
             0b10000000,
@@ -529,11 +1296,11 @@ class TMS9918A
         bool mag = this->ctx->reg[1] & 0b00000001;
         int sn = 0;
         int tsn = 0;
-        unsigned char dlog[256];
         unsigned char wlog[256];
-        memset(dlog, 0, sizeof(dlog));
+        memset(dlog, 0, 256);
         memset(wlog, 0, sizeof(wlog));
         bool limitOver = false;
+        int visible = 0;
         for (int i = 0; i < 32; i++) {
             int cur = ac.sa + i * 4;
             unsigned char y = this->ctx->ram[cur++];
@@ -569,7 +1336,7 @@ class TMS9918A
                             }
                             if (0 == dlog[x]) {
                                 if (this->ctx->ram[cur] & bit[j / 2]) {
-                                    if (col && rendering) renderPosition[x] = this->palette[col];
+                                    visible |= col;
                                     dlog[x] = col;
                                     wlog[x] = 1;
                                 }
@@ -584,7 +1351,7 @@ class TMS9918A
                             }
                             if (0 == dlog[x]) {
                                 if (this->ctx->ram[cur] & bit[j / 2]) {
-                                    if (col && rendering) renderPosition[x] = this->palette[col];
+                                    visible |= col;
                                     dlog[x] = col;
                                     wlog[x] = 1;
                                 }
@@ -615,7 +1382,7 @@ class TMS9918A
                             }
                             if (0 == dlog[x]) {
                                 if (this->ctx->ram[cur] & bit[j / 2]) {
-                                    if (col && rendering) renderPosition[x] = this->palette[col];
+                                    visible |= col;
                                     dlog[x] = col;
                                     wlog[x] = 1;
                                 }
@@ -649,7 +1416,7 @@ class TMS9918A
                             }
                             if (0 == dlog[x]) {
                                 if (this->ctx->ram[cur] & bit[j]) {
-                                    if (col && rendering) renderPosition[x] = this->palette[col];
+                                    visible |= col;
                                     dlog[x] = col;
                                     wlog[x] = 1;
                                 }
@@ -664,7 +1431,7 @@ class TMS9918A
                             }
                             if (0 == dlog[x]) {
                                 if (this->ctx->ram[cur] & bit[j]) {
-                                    if (col && rendering) renderPosition[x] = this->palette[col];
+                                    visible |= col;
                                     dlog[x] = col;
                                     wlog[x] = 1;
                                 }
@@ -695,7 +1462,7 @@ class TMS9918A
                             }
                             if (0 == dlog[x]) {
                                 if (this->ctx->ram[cur] & bit[j]) {
-                                    if (col && rendering) renderPosition[x] = this->palette[col];
+                                    visible |= col;
                                     dlog[x] = col;
                                     wlog[x] = 1;
                                 }
@@ -706,6 +1473,7 @@ class TMS9918A
                 }
             }
         }
+        return 0 != visible;
     }
 };
 
@@ -0,0 +1,207 @@
+/**
+ * vga32-msx - TMS9918A Output Scaler
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_VDPSCALER_HPP
+#define INCLUDE_VDPSCALER_HPP
+
+#include <stdlib.h>
+#include <string.h>
+#include "tms9918a.hpp"
+
+// Maps the 256x192 active area and the 284x240 border area (TMS9918A_SCREEN_WIDTH x TMS9918A_SCREEN_HEIGHT)
+// of the VDP to the display. The mappings are precomputed by setup, so each line is output as whole spans:
+// the border spans are filled with the backdrop color and the active span is copied or expanded through the table.
+// NOTE: the span edges are aligned to 4 pixels to keep the pixel order of RGB222_Swap (x ^ 2) in every span.
+class VDPScaler
+{
+  public:
+    enum class Mode {
+        Center, // 1:1 at the center (the border area is not drawn)
+        Border, // 1:1 at the center with the border area
+        Double, // 2x with the border area
+        Aspect, // the border area fitted to the display height at the 4:3 aspect ratio
+    };
+
+  private:
+    Mode mode;
+    int width;
+    int height;
+    int swapMask;
+    bool fillBorder;
+    int borderX; // border area in the display
+    int borderWidth;
+    int borderY;
+    int borderHeight;
+    int activeX; // active area in the display
+    int activeWidth;
+    int activeY;
+    int activeHeight;
+    bool copy;               // the active span is a copy of the source line
+    unsigned short* hmap;    // source pixel of each pixel in the active span
+    short firstLine[192];    // first display line of each source line
+    short lineCount[192];    // display lines of each source line
+    unsigned short backdrop; // backdrop color of the border lines drawn last
+    bool borderLinesValid;
+    void* arg;
+    void* (*getLine)(void* arg, int y);
+    Arena* arena;
+
+    static inline void fillSpan(unsigned char* dst, int count, unsigned short color) { memset(dst, color, count); }
+    static inline void fillSpan(unsigned short* dst, int count, unsigned short color)
+    {
+        for (int i = 0; i < count; i++) dst[i] = color;
+    }
+
+  public:
+    VDPScaler()
+    {
+        this->hmap = nullptr;
+        this->getLine = nullptr;
+        this->arena = nullptr;
+    }
+
+    ~VDPScaler()
+    {
+        Arena::free(this->arena, this->hmap);
+    }
+
+    // allocate the table from the arena (call before setup)
+    void setArena(Arena* arena) { this->arena = arena; }
+
+    // width x height: the display; swap: the lines are in the order of RGB222_Swap; getLine: returns the display line y
+    // returns false if the mode does not fit in the display
+    bool setup(Mode mode, int width, int height, bool swap, void* arg, void* (*getLine)(void* arg, int y))
+    {
+        int hn = 1, hd = 1; // horizontal scale (hn / hd)
+        int vn = 1, vd = 1; // vertical scale (vn / vd)
+        switch (mode) {
+            case Mode::Double: hn = vn = 2; break;
+            case Mode::Aspect:
+                hn = height * 4 / 3;
+                hd = TMS9918A_SCREEN_WIDTH;
+                vn = height;
+                vd = TMS9918A_SCREEN_HEIGHT;
+                break;
+            default: break;
+        }
+        int aw = (256 * hn / hd) & ~3;
+        int ah = 192 * vn / vd;
+        if (width < aw || height < ah) return false;
+        int bw = (TMS9918A_SCREEN_WIDTH * hn / hd + 3) & ~3;
+        int bh = TMS9918A_SCREEN_HEIGHT * vn / vd;
+        this->mode = mode;
+        this->width = width;
+        this->height = height;
+        this->swapMask = swap ? 2 : 0;
+        this->fillBorder = Mode::Center != mode;
+        this->borderWidth = width < bw ? (width & ~3) : bw;
+        this->borderX = ((width - this->borderWidth) / 2) & ~3;
+        this->borderHeight = height < bh ? height : bh;
+        this->borderY = (height - this->borderHeight) / 2;
+        this->activeWidth = aw;
+        this->activeX = ((width - aw) / 2) & ~3;
+        this->activeHeight = ah;
+        this->activeY = (height - ah) / 2;
+        this->copy = 256 == aw;
+        Arena::free(this->arena, this->hmap);
+        this->hmap = (unsigned short*)Arena::alloc(this->arena, Arena::Scope::Machine, aw * sizeof(unsigned short));
+        for (int x = 0; x < aw; x++) {
+            int rx = ((this->activeX + x) ^ this->swapMask) - this->activeX;
+            this->hmap[rx] = (x * 256 / aw) ^ this->swapMask;
+        }
+        memset(this->lineCount, 0, sizeof(this->lineCount));
+        for (int y = ah - 1; 0 <= y; y--) {
+            int line = y * 192 / ah;
+            this->firstLine[line] = this->activeY + y;
+            this->lineCount[line]++;
+        }
+        this->borderLinesValid = false;
+        this->arg = arg;
+        this->getLine = getLine;
+        return true;
+    }
+
+    // destination to render the source line in place (nullptr: render to a buffer and output it with putLine)
+    template <typename T>
+    inline T* getActiveLine(int line)
+    {
+        if (!this->copy || 1 != this->lineCount[line]) return nullptr;
+        return (T*)this->getLine(this->arg, this->firstLine[line]) + this->activeX;
+    }
+
+    // output a source line rendered to a buffer
+    template <typename T>
+    inline void putLine(int line, const T* src, unsigned short backdrop)
+    {
+        for (int i = 0; i < this->lineCount[line]; i++) {
+            T* dst = (T*)this->getLine(this->arg, this->firstLine[line] + i);
+            if (this->copy) {
+                memcpy(dst + this->activeX, src, 256 * sizeof(T));
+            } else {
+                T* p = dst + this->activeX;
+                for (int x = 0; x < this->activeWidth; x++) p[x] = src[this->hmap[x]];
+            }
+            this->putBorderSpans(dst, backdrop);
+        }
+        if (191 == line) this->putBorderLines<T>(backdrop);
+    }
+
+    // output the border of a source line rendered in place to getActiveLine
+    template <typename T>
+    inline void putBorders(int line, unsigned short backdrop)
+    {
+        this->putBorderSpans((T*)this->getLine(this->arg, this->firstLine[line]), backdrop);
+        if (191 == line) this->putBorderLines<T>(backdrop);
+    }
+
+    // fill the border lines above and below the active area again at the next frame (after the display has been cleared)
+    void invalidateBorders() { this->borderLinesValid = false; }
+
+    // fill the lines of the border area above and below the active area (only when the backdrop color has been changed)
+    template <typename T>
+    void putBorderLines(unsigned short backdrop)
+    {
+        if (!this->fillBorder || (this->borderLinesValid && backdrop == this->backdrop)) return;
+        for (int y = this->borderY; y < this->borderY + this->borderHeight; y++) {
+            if (this->activeY <= y && y < this->activeY + this->activeHeight) continue;
+            fillSpan((T*)this->getLine(this->arg, y) + this->borderX, this->borderWidth, backdrop);
+        }
+        this->backdrop = backdrop;
+        this->borderLinesValid = true;
+    }
+
+  private:
+    template <typename T>
+    inline void putBorderSpans(T* dst, unsigned short backdrop)
+    {
+        if (!this->fillBorder) return;
+        fillSpan(dst + this->borderX, this->activeX - this->borderX, backdrop);
+        int right = this->activeX + this->activeWidth;
+        fillSpan(dst + right, this->borderX + this->borderWidth - right, backdrop);
+    }
+};
+
+#endif // INCLUDE_VDPSCALER_HPP
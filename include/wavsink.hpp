@@ -0,0 +1,112 @@
+/**
+ * vga32-msx - WAV File Sound Sink
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_WAVSINK_HPP
+#define INCLUDE_WAVSINK_HPP
+
+#include <stdio.h>
+#include "soundring.hpp"
+
+// Consumes a SoundRing into a 16bit mono WAV file (stands in for the DAC on the host)
+class WavSink
+{
+  private:
+    FILE* fp;
+    unsigned int sampleRate;
+    unsigned int dataSize;
+
+    void putLE(unsigned int value, int bytes)
+    {
+        for (int i = 0; i < bytes; i++) {
+            fputc((value >> (i * 8)) & 0xFF, this->fp);
+        }
+    }
+
+    void writeHeader()
+    {
+        fwrite("RIFF", 1, 4, this->fp);
+        this->putLE(36 + this->dataSize, 4);
+        fwrite("WAVEfmt ", 1, 8, this->fp);
+        this->putLE(16, 4);                    // fmt chunk size
+        this->putLE(1, 2);                     // PCM
+        this->putLE(1, 2);                     // mono
+        this->putLE(this->sampleRate, 4);      // sample rate
+        this->putLE(this->sampleRate * 2, 4);  // byte rate
+        this->putLE(2, 2);                     // block align
+        this->putLE(16, 2);                    // bits per sample
+        fwrite("data", 1, 4, this->fp);
+        this->putLE(this->dataSize, 4);
+    }
+
+  public:
+    WavSink()
+    {
+        this->fp = nullptr;
+        this->sampleRate = 44100;
+        this->dataSize = 0;
+    }
+
+    ~WavSink() { this->close(); }
+
+    bool open(const char* path, unsigned int sampleRate = 44100)
+    {
+        this->close();
+        this->fp = fopen(path, "wb");
+        if (!this->fp) return false;
+        this->sampleRate = sampleRate;
+        this->dataSize = 0;
+        this->writeHeader();
+        return true;
+    }
+
+    // pulls count samples in the same way as the DAC DMA (priming and underruns are recorded as held samples)
+    void consume(SoundRing* ring, unsigned int count)
+    {
+        short samples[256];
+        while (count) {
+            unsigned int n = count < 256 ? count : 256;
+            ring->read(samples, n);
+            if (this->fp) {
+                for (unsigned int i = 0; i < n; i++) {
+                    this->putLE((unsigned short)samples[i], 2);
+                }
+                this->dataSize += n * 2;
+            }
+            count -= n;
+        }
+    }
+
+    void close()
+    {
+        if (!this->fp) return;
+        fseek(this->fp, 0, SEEK_SET);
+        this->writeHeader();
+        fclose(this->fp);
+        this->fp = nullptr;
+    }
+};
+
+#endif // INCLUDE_WAVSINK_HPP
@@ -0,0 +1,91 @@
+#pragma GCC optimize ("O2")
+
+#include <string.h>
+#include "audioout.h"
+#include "iopins.h"
+#include "driver/i2s.h"
+#include "Arduino.h"
+
+#define DEBUG true
+
+AudioOutput::AudioOutput()
+{
+  this->ring = nullptr;
+  this->task = nullptr;
+  this->sampleRate = 44100;
+}
+
+AudioOutput::~AudioOutput()
+{
+  this->end();
+}
+
+bool AudioOutput::begin(SoundRing * ring, int sampleRate, int latencyMillis)
+{
+  #if DEBUG
+    Serial.printf("AudioOutput::begin() - %dHz, %dms\n", sampleRate, latencyMillis);
+  #endif
+
+  this->ring = ring;
+  this->sampleRate = sampleRate;
+  this->setLatency(latencyMillis);
+
+  // the built-in DAC takes the upper 8 bits of the unsigned 16bit samples (right channel: GPIO 25)
+  i2s_config_t config;
+  memset(&config, 0, sizeof(config));
+  config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX | I2S_MODE_DAC_BUILT_IN);
+  config.sample_rate = sampleRate;
+  config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+  config.channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT;
+  config.communication_format = I2S_COMM_FORMAT_I2S_MSB;
+  config.dma_buf_count = DMA_BUFFERS;
+  config.dma_buf_len = DMA_FRAMES;
+  config.use_apll = false;
+  if (ESP_OK != i2s_driver_install(I2S_NUM_0, &config, 0, NULL)) {
+    #if DEBUG
+      Serial.println("AudioOutput::begin() - i2s_driver_install failed");
+    #endif
+    return false;
+  }
+  i2s_set_pin(I2S_NUM_0, NULL);
+  i2s_set_dac_mode(I2S_DAC_CHANNEL_RIGHT_EN); // DAC1 = VGA32_AUD
+  i2s_zero_dma_buffer(I2S_NUM_0);
+
+  xTaskCreatePinnedToCore(audioTask, "audio", 2048, this, 6, &this->task, 0);
+  return true;
+}
+
+void AudioOutput::end()
+{
+  if (!this->task) {
+    return;
+  }
+  vTaskDelete(this->task);
+  this->task = nullptr;
+  i2s_driver_uninstall(I2S_NUM_0);
+}
+
+// the DMA buffers are a part of the latency: the ring is primed with the rest
+void AudioOutput::setLatency(int latencyMillis)
+{
+  int samples = this->sampleRate * latencyMillis / 1000 - DMA_BUFFERS * DMA_FRAMES;
+  this->ring->setLatency(samples < DMA_FRAMES ? DMA_FRAMES : samples);
+}
+
+// i2s_write blocks until a DMA buffer is free, so it paces the task at the DAC rate
+void AudioOutput::audioTask(void * arg)
+{
+  AudioOutput * a = (AudioOutput *)arg;
+  short samples[DMA_FRAMES];
+  unsigned short frames[DMA_FRAMES * 2];
+  while (true) {
+    a->ring->read(samples, DMA_FRAMES);
+    for (int i = 0; i < DMA_FRAMES; i++) {
+      unsigned short value = (unsigned short)(samples[i] + 0x8000);
+      frames[i * 2] = value;
+      frames[i * 2 + 1] = value;
+    }
+    size_t written;
+    i2s_write(I2S_NUM_0, frames, sizeof(frames), &written, portMAX_DELAY);
+  }
+}
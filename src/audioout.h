@@ -0,0 +1,30 @@
+#include "soundring.hpp"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#pragma once
+
+// Plays a SoundRing on the built-in DAC (VGA32_AUD) through the I2S DMA
+class AudioOutput {
+
+  SoundRing * ring;
+  TaskHandle_t task;
+  int sampleRate;
+
+public:
+
+  static const int DMA_BUFFERS = 4;
+  static const int DMA_FRAMES = 256; // samples per DMA buffer
+
+  AudioOutput();
+  ~AudioOutput();
+
+  // latency: total output latency (ring priming + DMA buffers)
+  bool begin(SoundRing * ring, int sampleRate, int latencyMillis);
+  void end();
+  void setLatency(int latencyMillis);
+  SoundRing::Stats getStats() { return this->ring->getStats(); }
+
+private:
+
+  static void audioTask(void * arg);
+};
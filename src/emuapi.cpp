@@ -1,21 +1,21 @@
 #include <malloc.h>
 #include "emuapi.h"
 
-static int malbufpt = 0;
 static char malbuf[EXTRA_HEAP];
 
-void * emu_Malloc(unsigned int size)
+// all emulator memory is carved from this arena (the heap is used only when it is full)
+Arena * emu_Arena()
 {
-  void * retval =  malloc(size);
-  if (!retval) {
-
-    if ( (malbufpt+size) < sizeof(malbuf) ) {
-      retval = (void *)&malbuf[malbufpt];
-      malbufpt += size;      
-    }
+  static Arena arena(malbuf, sizeof(malbuf));
+  return &arena;
+}
 
-  }
-  
-  return retval;
+void * emu_Malloc(unsigned int size)
+{
+  return Arena::alloc(emu_Arena(), Arena::Scope::Machine, size);
 }
 
+void emu_Free(void * ptr)
+{
+  Arena::free(emu_Arena(), ptr);
+}
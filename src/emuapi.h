@@ -1,3 +1,7 @@
 #define EXTRA_HEAP           0x30000
 
-void * emu_Malloc(unsigned int size);
\ No newline at end of file
+#include "arena.hpp"
+
+Arena * emu_Arena();
+void * emu_Malloc(unsigned int size);
+void emu_Free(void * ptr);
@@ -6,6 +6,7 @@
 #include "fabgl.h"
 #include "emuapi.h"
 #include <ff.h>
+#include "esp_timer.h"
 
 #define DEBUG true
 
@@ -17,10 +18,53 @@ Machine::Machine(fabgl::VGAController * displayController)
     Serial.println("Machine::Machine() - Initializing the MSX computer");
   #endif
 
-  // Initialize the MSX computer
-  this->mmu.setupRAM(this->ram, 0x4000); //16kb
+  // Initialize the MSX computer (its VDP logs the port accesses instead of rendering)
+  this->ram = (unsigned char *)emu_Malloc(RAM_SIZE);
+  this->msx = new MSX1(TMS9918A::ColorMode::RGB222_Swap, this->ram, RAM_SIZE, &this->vram, nullptr, emu_Arena());
+  this->msx->vdp.useOwnDisplayBuffer(nullptr, 0);
+  this->msx->vdp.setPortLog(&this->vdpLog);
+  this->msx->vdp.setBatchRendering(true);
+
+  // Initialize the renderer VDP to render into the VGA controller line buffers (centered with the border area)
+  this->displayController = displayController;
+  this->scaler.setArena(emu_Arena());
+  this->scaler.setup(VDPScaler::Mode::Border, displayController->getViewPortWidth(), displayController->getViewPortHeight(), true, this, scaler_getLine);
+
+  // The frames are rendered on core 0 from the port accesses logged by the emulation on core 1
+  this->vdpRenderer.setArena(emu_Arena());
+  this->vdpRenderer.initialize(TMS9918A::ColorMode::RGB222_Swap, this, [](void * arg) {}, [](void * arg) {}, nullptr, nullptr, 0);
+  for (int i = 0; i < 16; i++) {
+    unsigned int rgb = TMS9918A::rgb888()[i];
+    this->vdpRenderer.setPalette(i, displayController->createRawPixel(RGB222((rgb >> 22) & 3, (rgb >> 14) & 3, (rgb >> 6) & 3)));
+  }
+  TMS9918A::DisplaySink sink = { this, vdp_getLine, vdp_lineRendered };
+  this->vdpRenderer.useDisplaySink(sink);
+  this->vdpRenderer.setDirtyTracking(true); // the VGA scanlines keep their pixels between frames (see redraw)
+  this->vdpRenderer.syncContext(this->msx->vdp.ctx);
+  this->vdpRenderer.setFrameSkip(MAX_FRAME_SKIP, FRAME_MICROS); // fed with the render time of each frame by the render task
+  this->vdpSyncRequest = false;
+  this->vdpRenderMicros = 0;
+  xTaskCreatePinnedToCore(vdp_renderTask, "vdp", 4096, this, 5, &this->vdpRenderTask, 0);
+
+  // The samples are played on the DAC from the sound ring (filled by the PSG task)
+  this->audioOutput.begin(&this->soundRing, 44100, 50);
+
+  // The PSG runs on core 0 from the register writes posted by the emulation
+#ifdef MSX1_REMOVE_PSG
+  this->psgAudio.begin(&this->soundRing);
+  this->psgAudio.attach(&this->msx->psgDelegate);
+  this->psgAudio.setClock(this, psg_clock);
+#else
+  this->msx->setSoundRing(&this->soundRing);
+#endif
+  this->nextFrameMicros = 0;
 
+  #if DEBUG
+    const Arena::Stats * arena = emu_Arena()->getStats();
+    Serial.printf("Machine::Machine() - Arena: %u/%u bytes (high water %u, heap fallbacks %u)\n", arena->used[0] + arena->used[1] + arena->used[2], arena->capacity, arena->highWater, arena->fallbacks);
+  #endif
 
+  this->reset();
 }
 
 Machine::~Machine()
@@ -31,6 +75,11 @@ Machine::~Machine()
   #endif
 
   // Deinitialize the MSX computer
+  vTaskDelete(this->vdpRenderTask);
+  this->psgAudio.end();
+  this->audioOutput.end();
+  delete this->msx;
+  emu_Free(this->ram);
 }
 
 void Machine::reset()
@@ -39,31 +88,115 @@ void Machine::reset()
     Serial.println("Machine::reset()");
   #endif
 
-  memset(&this->cpu.reg, 0, sizeof(this->cpu.reg));
-  memset(&this->cpu.reg.pair, 0xFF, sizeof(this->cpu.reg.pair));
-  memset(&this->cpu.reg.back, 0xFF, sizeof(this->cpu.reg.back));
+  this->msx->reset();
+  this->vdp_sync();
+}
 
-  this->cpu.reg.SP = 0xF000;
-  this->cpu.reg.IX = 0xFFFF;
-  this->cpu.reg.IY = 0xFFFF;
-  this->mmu.reset();
-  this->vdp.reset();
+// repaint all the lines and the border at the next frame (the unchanged lines are not rendered again)
+void Machine::redraw()
+{
+  this->scaler.invalidateBorders();
+  this->vdp_sync();
 }
 
+// emulate a frame, then sleep until its deadline
 void Machine::run()
 {
+  int64_t start = esp_timer_get_time();
+  this->msx->tick(0, 0, 0);
+#ifdef MSX1_REMOVE_PSG
+  this->psgAudio.endFrame();
+#endif
+  FrameStats stats;
+  stats.emulationMicros = (unsigned int)(esp_timer_get_time() - start);
+  stats.renderMicros = this->vdpRenderMicros.exchange(0);
+  stats.idleMicros = this->waitNextFrame();
+  this->frameStats.push(stats);
+}
 
-// z80 ticker
+// sleep until the deadline of the next frame (the drift against the DAC clock is absorbed by the PSG resampling), and returns the slept time
+unsigned int Machine::waitNextFrame()
+{
+  int64_t now = esp_timer_get_time();
+  this->nextFrameMicros += FRAME_MICROS;
+  if (this->nextFrameMicros < now - FRAME_MICROS * 4) {
+    this->nextFrameMicros = now; // resync after a stall (e.g. the menu)
+  }
+  int64_t wait = this->nextFrameMicros - now;
+  if (1000 <= wait) {
+    vTaskDelay(pdMS_TO_TICKS(wait / 1000));
+  }
+  return (unsigned int)(esp_timer_get_time() - now);
+}
 
-// vdp ticker
+// CPU clocks from the start of the frame (a VDP line is 228 CPU clocks of 342 dots)
+unsigned int Machine::psg_clock(void * arg)
+{
+  TMS9918A::Context * ctx = ((Machine *)arg)->msx->vdp.ctx;
+  return (unsigned int)(ctx->countV * 342 + ctx->countH) * 2 / 3;
+}
 
-// psg ticker
+// copy the context of the emulation VDP to the renderer (the emulation must be stopped)
+void Machine::vdp_sync()
+{
+  this->vdpSyncRequest = true;
+  while (this->vdpSyncRequest) {
+    vTaskDelay(1);
+  }
+}
 
+void Machine::vdp_renderTask(void * arg)
+{
+  Machine * m = (Machine *)arg;
+  unsigned int frame = m->vdpRenderer.ctx->frame;
+  unsigned int frameMicros = 0; // spent on the frames replayed since the last completed one
+  while (true) {
+    int64_t start = esp_timer_get_time();
+    if (m->vdpRenderer.replayPortLog(&m->vdpLog)) {
+      unsigned int micros = (unsigned int)(esp_timer_get_time() - start);
+      m->vdpRenderMicros += micros;
+      frameMicros += micros;
+      // the frame skip of the renderer decides at each frame start whether the frame is output
+      unsigned int frames = (m->vdpRenderer.ctx->frame - frame) & 0xFFFF;
+      if (frames) {
+        for (unsigned int i = 0; i < frames; i++) {
+          m->vdpRenderer.updateFrameSkip(frameMicros / frames);
+        }
+        frame = m->vdpRenderer.ctx->frame;
+        frameMicros = 0;
+      }
+      continue;
+    }
+    if (m->vdpSyncRequest) {
+      m->vdpRenderer.syncContext(m->msx->vdp.ctx);
+      frame = m->vdpRenderer.ctx->frame;
+      frameMicros = 0;
+      m->vdpSyncRequest = false;
+    }
+    vTaskDelay(1);
+  }
 }
 
-void Machine::vdp_tick()
+void * Machine::vdp_getLine(void * arg, int frame, int line)
 {
-  
+  Machine * m = (Machine *)arg;
+  unsigned char * dst = m->scaler.getActiveLine<unsigned char>(line);
+  return dst ? dst : m->lineBuffer;
+}
+
+void Machine::vdp_lineRendered(void * arg, int frame, int line, void * dst)
+{
+  Machine * m = (Machine *)arg;
+  if (dst == m->lineBuffer) {
+    m->scaler.putLine<unsigned char>(line, m->lineBuffer, m->vdpRenderer.getBackdropColor());
+  } else {
+    m->scaler.putBorders<unsigned char>(line, m->vdpRenderer.getBackdropColor());
+  }
+}
+
+void * Machine::scaler_getLine(void * arg, int y)
+{
+  return ((Machine *)arg)->displayController->getScanline(y);
 }
 
 
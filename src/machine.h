@@ -1,10 +1,13 @@
-
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
 
-#include "ay8910.hpp"
+#include "audioout.h"
+#include "framestats.hpp"
 #include "msx1.hpp"
+#include "psgaudio.h"
+#include "vdpscaler.hpp"
 #include "fabgl.h"
 #pragma once
 
@@ -13,9 +16,22 @@ class Machine {
   unsigned char* ram;
   TMS9918A::Context vram;
 
-  Z80 cpu;
-  MSX1MMU mmu;
-  TMS9918A vdp;
+  fabgl::VGAController * displayController;
+  VDPScaler scaler;
+  unsigned char lineBuffer[256]; // VDP line to be scaled (when it cannot be rendered in place)
+
+  MSX1 * msx;           // its VDP emulates the timing, the sprites and the status, and logs the port accesses
+  TMS9918A vdpRenderer; // replays the logged port accesses and renders the frames on the other core
+  TMS9918A::PortLog vdpLog;
+  TaskHandle_t vdpRenderTask;
+  volatile bool vdpSyncRequest;
+  std::atomic<unsigned int> vdpRenderMicros; // spent by the renderer since the last frame
+
+  SoundRing soundRing;
+  AudioOutput audioOutput;
+  PsgAudio psgAudio;
+
+  FrameStatsRing frameStats;
 
 public:
 
@@ -24,10 +40,27 @@ public:
 
   void reset();
   void run();
+  void redraw(); // after the screen has been drawn over (e.g. by the menu)
+
+  FrameStatsRing * getFrameStats() { return &this->frameStats; }
+  const TMS9918A::FrameSkip & getFrameSkipStats() { return this->vdpRenderer.frameSkip; } // of the renderer
+
 private:
 
-  const int CPU_CLOCK = 3579545;
-  const int VDP_CLOCK = 5370863;
+  const int RAM_SIZE = 0x4000; // 16KB
+  const int FRAME_MICROS = 16688; // 262 lines of 228 CPU clocks
+  const int MAX_FRAME_SKIP = 3;   // renders at least 1 of 4 frames when the renderer cannot keep up
+
+  int64_t nextFrameMicros;
+  unsigned int waitNextFrame();
+
+  // VDP display sink: lines are rendered in place into the VGA controller line buffers when the scaler allows it
+  static void * vdp_getLine(void * arg, int frame, int line);
+  static void vdp_lineRendered(void * arg, int frame, int line, void * dst);
+  static void * scaler_getLine(void * arg, int y);
+
+  static void vdp_renderTask(void * arg);
+  void vdp_sync();
 
-  void vdp_tick();
-};
\ No newline at end of file
+  static unsigned int psg_clock(void * arg);
+};
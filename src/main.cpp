@@ -286,6 +286,7 @@ class Menu : public uiApp {
     cv->setBrushColor(0, 0, 0);
     cv->clear();
     cv->waitCompletion();
+    machine->redraw();
 
     bool run = true;
     while (run) {
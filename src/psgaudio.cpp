@@ -0,0 +1,86 @@
+#pragma GCC optimize ("O2")
+
+#include "psgaudio.h"
+#include "Arduino.h"
+
+#define DEBUG true
+
+PsgAudio * PsgAudio::instance = nullptr;
+
+PsgAudio::PsgAudio()
+{
+  this->ring = nullptr;
+  this->task = nullptr;
+}
+
+PsgAudio::~PsgAudio()
+{
+  this->end();
+}
+
+void PsgAudio::begin(SoundRing * ring)
+{
+  #if DEBUG
+    Serial.println("PsgAudio::begin()");
+  #endif
+
+  this->ring = ring;
+  instance = this;
+  this->psg.setBandLimited(true);
+  xTaskCreatePinnedToCore(audioTask, "psg", 4096, this, 6, &this->task, 0);
+}
+
+void PsgAudio::end()
+{
+  if (!this->task) {
+    return;
+  }
+  vTaskDelete(this->task);
+  this->task = nullptr;
+  if (instance == this) {
+    instance = nullptr;
+  }
+}
+
+#ifdef MSX1_REMOVE_PSG
+void PsgAudio::attach(MSX1::PsgDelegate * delegate)
+{
+  delegate->reset = []() { instance->psg.reset(); };
+  delegate->setPads = [](unsigned char pad1, unsigned char pad2) { instance->psg.setPads(pad1, pad2); };
+  delegate->read = []() { return instance->psg.read(); };
+  delegate->getPad1 = []() { return instance->psg.getPad1(); };
+  delegate->getPad2 = []() { return instance->psg.getPad2(); };
+  delegate->latch = [](unsigned char value) { instance->psg.latch(value); };
+  delegate->write = [](unsigned char value) { instance->psg.write(value); };
+  delegate->getContext = []() { return (const void *)instance->psg.getContext(); };
+  delegate->getContextSize = []() { return instance->psg.getContextSize(); };
+  delegate->setContext = [](const void * context, int size) { instance->psg.setContext(context, size); };
+  delegate->sccWrite = [](unsigned char offset, unsigned char value) { instance->psg.sccWrite(offset, value); };
+  delegate->getSccContext = []() { return instance->psg.getSccContext(); };
+  delegate->setSccContext = [](const void * context, int size) { instance->psg.setSccContext(context, size); };
+}
+#endif
+
+void PsgAudio::endFrame()
+{
+  this->psg.endFrame();
+  if (this->task) {
+    xTaskNotifyGive(this->task);
+  }
+}
+
+// sleeps until a frame is posted (the control commands such as the save state snapshots are served meanwhile)
+void PsgAudio::audioTask(void * arg)
+{
+  PsgAudio * p = (PsgAudio *)arg;
+  while (true) {
+    int count = p->psg.renderFrame(p->frame);
+    if (!count) {
+      p->psg.applyControl();
+      ulTaskNotifyTake(pdTRUE, 1);
+      continue;
+    }
+    unsigned int step = p->rate.update(p->ring->fill(), p->ring->getLatency());
+    p->ring->write(p->samples, p->resampler.process(p->frame, count, p->samples, step));
+  }
+}
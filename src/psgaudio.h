@@ -0,0 +1,40 @@
+#include "msx1.hpp"
+#include "psgproxy.hpp"
+#include "ratecontrol.hpp"
+#include "soundring.hpp"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#pragma once
+
+// Emulates the PSG on core 0 for an MSX1 built with MSX1_REMOVE_PSG (through MSX1::PsgDelegate).
+// The frames posted by endFrame are resampled into the sound ring by a ratio that holds the ring at its latency.
+class PsgAudio {
+
+  AY8910Proxy psg;
+  SoundRing * ring;
+  TaskHandle_t task;
+  SoundRateControl rate;
+  SoundResampler resampler;
+  short frame[AY8910Proxy::MAX_FRAME_SAMPLES];
+  short samples[AY8910Proxy::MAX_FRAME_SAMPLES + 16]; // resampled
+
+  static PsgAudio * instance; // the delegate functions take no argument
+
+public:
+
+  PsgAudio();
+  ~PsgAudio();
+
+  void begin(SoundRing * ring);
+  void end();
+  void setClock(void * arg, unsigned int (*clock)(void * arg)) { this->psg.setClock(arg, clock); }
+  void endFrame();
+  int getRateAdjust() { return this->rate.getAdjust(); } // 1/65536 of the output rate
+#ifdef MSX1_REMOVE_PSG
+  void attach(MSX1::PsgDelegate * delegate);
+#endif
+
+private:
+
+  static void audioTask(void * arg);
+};
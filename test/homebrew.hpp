@@ -0,0 +1,388 @@
+/**
+ * vga32-msx - Homebrew Test Programs
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef TEST_HOMEBREW_HPP
+#define TEST_HOMEBREW_HPP
+
+#include <initializer_list>
+#include <string.h>
+#include "msx1.hpp"
+
+// The corpus of the host tests: small programs hand-assembled into a 32KB system ROM (slot 0),
+// so that the tests need no BIOS or game image. Each program drives the hardware directly,
+// runs from the VDP interrupt (IM 1) and reacts to the scripted input.
+class Homebrew
+{
+  public:
+    enum class Program {
+        Screens, // the 4 screen modes in turn, 6 sprites (a 5th sprite line, collisions), joystick and keyboard
+        Psg,     // tones, noise and the envelope shapes through the mixer settings (including the envelope-only channel)
+        Scc,     // the SCC of a Konami cartridge (waves, periods, volumes) mixed with a PSG tone
+    };
+    static const int PROGRAMS = 3;
+    static const int FRAMES = 240;
+
+  private:
+    // RAM (page 3 = slot 3)
+    static const int FRAME_COUNTER = 0xE000; // 16 bits, counted by the interrupt handler
+    static const int SPRITES = 0xE002;       // sprite attributes: 6 sprites of 4 bytes and the terminator
+    static const int BACKDROP = 0xE020;
+
+    // subroutines
+    static const int VDP_REGISTERS = 0x0050; // HL: pairs of a register and a value, terminated by 0xFF
+    static const int PSG_REGISTERS = 0x0068; // HL: pairs of a register and a value, terminated by 0xFF
+    static const int VRAM_FILL = 0x0080;     // DE: address, BC: count, H: first value, L: step
+    static const int VRAM_WRITE = 0x00A0;    // DE: address, HL: source, BC: count
+    static const int PSG_WRITE = 0x00C0;     // A: register, E: value
+    static const int MAIN = 0x0100;
+    static const int DATA = 0x1000;
+
+    class Assembler
+    {
+      public:
+        unsigned char* rom;
+        int pc;
+
+        Assembler(unsigned char* rom) : rom(rom), pc(0) { memset(rom, 0xFF, 0x8000); }
+        void org(int addr) { this->pc = addr; }
+        void db(std::initializer_list<int> bytes)
+        {
+            for (int b : bytes) this->rom[this->pc++] = (unsigned char)b;
+        }
+        int here() { return this->pc; }
+        // JR cc / DJNZ to a preceding label
+        void jr(int opcode, int target) { this->db({opcode, (target - (this->pc + 2)) & 0xFF}); }
+        // JR cc to the following label (returns the offset to be set by land)
+        int jrForward(int opcode)
+        {
+            this->db({opcode, 0});
+            return this->pc - 1;
+        }
+        void land(int offset) { this->rom[offset] = (unsigned char)(this->pc - (offset + 1)); }
+        // JP / CALL
+        void jp(int opcode, int target) { this->db({opcode, target & 0xFF, (target >> 8) & 0xFF}); }
+    };
+
+    static void header(Assembler& a, unsigned char primary)
+    {
+        a.org(0x0000);
+        a.db({0xF3});                                         // di
+        a.db({0xED, 0x56});                                   // im 1
+        a.db({0x3E, primary, 0xD3, 0xA8});                    // ld a,primary / out (0A8h),a
+        a.db({0x31, 0x00, 0xF0});                             // ld sp,0F000h
+        a.jp(0xC3, MAIN);                                     // jp main
+        a.org(0x0038);                                        // interrupt:
+        a.db({0xF5, 0xE5});                                   // push af / push hl
+        a.db({0xDB, 0x99});                                   // in a,(99h) ; acknowledge
+        a.db({0x2A, FRAME_COUNTER & 0xFF, FRAME_COUNTER >> 8}); // ld hl,(counter)
+        a.db({0x23});                                         // inc hl
+        a.db({0x22, FRAME_COUNTER & 0xFF, FRAME_COUNTER >> 8}); // ld (counter),hl
+        a.db({0xE1, 0xF1, 0xFB, 0xC9});                       // pop hl / pop af / ei / ret
+
+        a.org(VDP_REGISTERS);
+        int loop = a.here();
+        a.db({0x7E, 0xFE, 0xFF, 0xC8}); // ld a,(hl) / cp 0FFh / ret z
+        a.db({0x47, 0x23, 0x7E, 0x23}); // ld b,a / inc hl / ld a,(hl) / inc hl
+        a.db({0xD3, 0x99});             // out (99h),a
+        a.db({0x78, 0xF6, 0x80});       // ld a,b / or 80h
+        a.db({0xD3, 0x99});             // out (99h),a
+        a.jr(0x18, loop);               // jr loop
+
+        a.org(PSG_REGISTERS);
+        loop = a.here();
+        a.db({0x7E, 0xFE, 0xFF, 0xC8}); // ld a,(hl) / cp 0FFh / ret z
+        a.db({0xD3, 0xA0, 0x23});       // out (0A0h),a / inc hl
+        a.db({0x7E, 0xD3, 0xA1, 0x23}); // ld a,(hl) / out (0A1h),a / inc hl
+        a.jr(0x18, loop);               // jr loop
+
+        a.org(VRAM_FILL);
+        a.db({0x7B, 0xD3, 0x99});       // ld a,e / out (99h),a
+        a.db({0x7A, 0xF6, 0x40});       // ld a,d / or 40h
+        a.db({0xD3, 0x99});             // out (99h),a
+        loop = a.here();
+        a.db({0x7C, 0xD3, 0x98});       // ld a,h / out (98h),a
+        a.db({0x85, 0x67});             // add a,l / ld h,a
+        a.db({0x0B, 0x78, 0xB1});       // dec bc / ld a,b / or c
+        a.jr(0x20, loop);               // jr nz,loop
+        a.db({0xC9});                   // ret
+
+        a.org(VRAM_WRITE);
+        a.db({0x7B, 0xD3, 0x99});       // ld a,e / out (99h),a
+        a.db({0x7A, 0xF6, 0x40});       // ld a,d / or 40h
+        a.db({0xD3, 0x99});             // out (99h),a
+        loop = a.here();
+        a.db({0x7E, 0xD3, 0x98, 0x23}); // ld a,(hl) / out (98h),a / inc hl
+        a.db({0x0B, 0x78, 0xB1});       // dec bc / ld a,b / or c
+        a.jr(0x20, loop);               // jr nz,loop
+        a.db({0xC9});                   // ret
+
+        a.org(PSG_WRITE);
+        a.db({0xD3, 0xA0, 0x7B, 0xD3, 0xA1, 0xC9}); // out (0A0h),a / ld a,e / out (0A1h),a / ret
+    }
+
+    // frame loop entry: enables the interrupt and waits for the next frame
+    static int frameLoop(Assembler& a)
+    {
+        int loop = a.here();
+        a.db({0xFB, 0x76}); // ei / halt
+        return loop;
+    }
+
+    static void buildScreens(Assembler& a)
+    {
+        header(a, 0xC0); // page 3: RAM
+        // initial registers: Graphics II, 16x16 sprites, names 1800h, colors 2000h, patterns 0000h, sprite attributes 1B00h, sprite patterns 3800h
+        int registers = DATA;
+        a.org(registers);
+        a.db({0, 0x02, 1, 0xE2, 2, 0x06, 3, 0xFF, 4, 0x03, 5, 0x36, 6, 0x07, 7, 0xF4, 0xFF});
+        // the screen modes switched every 32 frames (16 bytes each): Graphics II, Graphics I (magnified sprites), Multicolor, Text
+        int modes = DATA + 0x20;
+        a.org(modes);
+        a.db({0, 0x02, 1, 0xE2, 3, 0xFF, 4, 0x03, 0xFF});
+        a.org(modes + 16);
+        a.db({0, 0x00, 1, 0xE3, 3, 0x80, 4, 0x00, 0xFF});
+        a.org(modes + 32);
+        a.db({0, 0x00, 1, 0xEA, 3, 0x80, 4, 0x00, 0xFF});
+        a.org(modes + 48);
+        a.db({0, 0x00, 1, 0xF2, 3, 0x80, 4, 0x00, 0xFF});
+        // sprites: 0 is moved by the joystick, 1-5 share a line (the 5th sprite is not displayed)
+        int sprites = DATA + 0x60;
+        a.org(sprites);
+        a.db({60, 40, 0, 0x0F, 100, 20, 4, 0x08, 100, 60, 8, 0x03, 100, 100, 12, 0x05, 100, 140, 16, 0x0A, 100, 180, 20, 0x0E, 0xD0});
+
+        a.org(MAIN);
+        a.db({0x21, registers & 0xFF, registers >> 8});      // ld hl,registers
+        a.jp(0xCD, VDP_REGISTERS);                           // call vdp_registers
+        a.db({0x11, 0x00, 0x00, 0x01, 0x00, 0x18});          // ld de,0000h / ld bc,1800h ; patterns
+        a.db({0x21, 0x3B, 0x00});                            // ld hl,003Bh
+        a.jp(0xCD, VRAM_FILL);                               // call vram_fill
+        a.db({0x11, 0x00, 0x20, 0x01, 0x00, 0x18});          // ld de,2000h / ld bc,1800h ; colors
+        a.db({0x21, 0x17, 0x1F});                            // ld hl,1F17h
+        a.jp(0xCD, VRAM_FILL);                               // call vram_fill
+        a.db({0x11, 0x00, 0x18, 0x01, 0x00, 0x03});          // ld de,1800h / ld bc,0300h ; names
+        a.db({0x21, 0x01, 0x00});                            // ld hl,0001h
+        a.jp(0xCD, VRAM_FILL);                               // call vram_fill
+        a.db({0x11, 0x00, 0x38, 0x01, 0x00, 0x08});          // ld de,3800h / ld bc,0800h ; sprite patterns
+        a.db({0x21, 0x07, 0xC3});                            // ld hl,0C307h
+        a.jp(0xCD, VRAM_FILL);                               // call vram_fill
+        a.db({0x21, sprites & 0xFF, sprites >> 8});          // ld hl,sprites
+        a.db({0x11, SPRITES & 0xFF, SPRITES >> 8});          // ld de,SPRITES
+        a.db({0x01, 25, 0x00, 0xED, 0xB0});                  // ld bc,25 / ldir
+        a.db({0x3E, 0x07, 0x1E, 0xBF});                      // ld a,7 / ld e,0BFh ; the joystick port is an input
+        a.jp(0xCD, PSG_WRITE);                               // call psg_write
+
+        int loop = frameLoop(a);
+        // switch the screen mode every 32 frames
+        a.db({0x3A, FRAME_COUNTER & 0xFF, FRAME_COUNTER >> 8}); // ld a,(counter)
+        a.db({0xE6, 0x1F});                                  // and 1Fh
+        int noSwitch = a.jrForward(0x20);                    // jr nz,no_switch
+        a.db({0x3A, FRAME_COUNTER & 0xFF, FRAME_COUNTER >> 8}); // ld a,(counter)
+        a.db({0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0xE6, 0x03});    // rrca x5 / and 3
+        a.db({0x6F, 0x26, 0x00, 0x29, 0x29, 0x29, 0x29});    // ld l,a / ld h,0 / add hl,hl x4
+        a.db({0x11, modes & 0xFF, modes >> 8, 0x19});        // ld de,modes / add hl,de
+        a.jp(0xCD, VDP_REGISTERS);                           // call vdp_registers
+        a.land(noSwitch);
+        // sprite 0 follows the joystick (PSG R#14)
+        a.db({0x3E, 0x0E, 0xD3, 0xA0, 0xDB, 0xA2, 0x4F});    // ld a,14 / out (0A0h),a / in a,(0A2h) / ld c,a
+        a.db({0x21, SPRITES & 0xFF, SPRITES >> 8});          // ld hl,SPRITES (Y)
+        a.db({0xCB, 0x41});                                  // bit 0,c ; up
+        int notUp = a.jrForward(0x20);                       // jr nz,not_up
+        a.db({0x35});                                        // dec (hl)
+        a.land(notUp);
+        a.db({0xCB, 0x49});                                  // bit 1,c ; down
+        int notDown = a.jrForward(0x20);                     // jr nz,not_down
+        a.db({0x34});                                        // inc (hl)
+        a.land(notDown);
+        a.db({0x23});                                        // inc hl (X)
+        a.db({0xCB, 0x51});                                  // bit 2,c ; left
+        int notLeft = a.jrForward(0x20);                     // jr nz,not_left
+        a.db({0x35, 0x35});                                  // dec (hl) x2
+        a.land(notLeft);
+        a.db({0xCB, 0x59});                                  // bit 3,c ; right
+        int notRight = a.jrForward(0x20);                    // jr nz,not_right
+        a.db({0x34, 0x34});                                  // inc (hl) x2
+        a.land(notRight);
+        // sprites 1-5 move by themselves (through each other and the sprite 0)
+        a.db({0x21, (SPRITES + 5) & 0xFF, (SPRITES + 5) >> 8, 0x34});        // ld hl,X1 / inc (hl)
+        a.db({0x21, (SPRITES + 9) & 0xFF, (SPRITES + 9) >> 8, 0x35, 0x35});  // ld hl,X2 / dec (hl) x2
+        a.db({0x21, (SPRITES + 12) & 0xFF, (SPRITES + 12) >> 8, 0x35});      // ld hl,Y3 / dec (hl)
+        a.db({0x21, (SPRITES + 17) & 0xFF, (SPRITES + 17) >> 8, 0x34, 0x34, 0x34}); // ld hl,X4 / inc (hl) x3
+        // the space key (row 8, bit 0) changes the backdrop color
+        a.db({0xDB, 0xAA, 0xE6, 0xF0, 0xF6, 0x08, 0xD3, 0xAA}); // in a,(0AAh) / and 0F0h / or 8 / out (0AAh),a
+        a.db({0xDB, 0xA9, 0xCB, 0x47});                      // in a,(0A9h) / bit 0,a
+        int noSpace = a.jrForward(0x20);                     // jr nz,no_space
+        a.db({0x3A, BACKDROP & 0xFF, BACKDROP >> 8, 0x3C});  // ld a,(backdrop) / inc a
+        a.db({0x32, BACKDROP & 0xFF, BACKDROP >> 8});        // ld (backdrop),a
+        a.db({0xE6, 0x0F, 0xF6, 0xF0, 0xD3, 0x99});          // and 0Fh / or 0F0h / out (99h),a
+        a.db({0x3E, 0x87, 0xD3, 0x99});                      // ld a,87h / out (99h),a
+        a.land(noSpace);
+        // update the sprite attributes
+        a.db({0x11, 0x00, 0x1B});                            // ld de,1B00h
+        a.db({0x21, SPRITES & 0xFF, SPRITES >> 8});          // ld hl,SPRITES
+        a.db({0x01, 25, 0x00});                              // ld bc,25
+        a.jp(0xCD, VRAM_WRITE);                              // call vram_write
+        // rewrite a row of the names (16 rows in turn)
+        a.db({0x3A, FRAME_COUNTER & 0xFF, FRAME_COUNTER >> 8}); // ld a,(counter)
+        a.db({0xE6, 0x0F, 0x6F, 0x26, 0x00});                // and 0Fh / ld l,a / ld h,0
+        a.db({0x29, 0x29, 0x29, 0x29, 0x29});                // add hl,hl x5
+        a.db({0x11, 0x00, 0x18, 0x19, 0xEB});                // ld de,1800h / add hl,de / ex de,hl
+        a.db({0x3A, FRAME_COUNTER & 0xFF, FRAME_COUNTER >> 8}); // ld a,(counter)
+        a.db({0x67, 0x2E, 0x03, 0x01, 0x20, 0x00});          // ld h,a / ld l,3 / ld bc,32
+        a.jp(0xCD, VRAM_FILL);                               // call vram_fill
+        a.jp(0xC3, loop);                                    // jp loop
+    }
+
+    static void buildPsg(Assembler& a)
+    {
+        header(a, 0xC0); // page 3: RAM
+        int registers = DATA;
+        a.org(registers);
+        a.db({0, 0x00, 1, 0xE0, 7, 0xF1, 0xFF}); // Graphics I, the display and the interrupt enabled
+        int sound = DATA + 0x10;
+        a.org(sound);
+        a.db({9, 0x0C, 10, 0x10, 12, 0x00, 4, 0x55, 5, 0x01, 0xFF});
+        // the mixer settings switched every 32 frames: all tones, all off (the envelope-only channel C), all noises,
+        // tone and noise mixed, ...
+        int mixers = 0x1100; // within a page
+        a.org(mixers);
+        a.db({0xB8, 0xBF, 0x87, 0xB0, 0xB6, 0xA9, 0x80, 0xBE});
+
+        a.org(MAIN);
+        a.db({0x21, registers & 0xFF, registers >> 8});      // ld hl,registers
+        a.jp(0xCD, VDP_REGISTERS);                           // call vdp_registers
+        a.db({0x21, sound & 0xFF, sound >> 8});              // ld hl,sound
+        a.jp(0xCD, PSG_REGISTERS);                           // call psg_registers
+
+        int loop = frameLoop(a);
+        a.db({0x3A, FRAME_COUNTER & 0xFF, FRAME_COUNTER >> 8, 0x47}); // ld a,(counter) / ld b,a
+        a.db({0x87, 0x87, 0x87, 0x5F, 0x3E, 0x00});          // add a,a x3 / ld e,a / ld a,0 ; R#0: c * 8
+        a.jp(0xCD, PSG_WRITE);                               // call psg_write
+        a.db({0x78, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0xE6, 0x03}); // ld a,b / rrca x5 / and 3
+        a.db({0x5F, 0x3E, 0x01});                            // ld e,a / ld a,1 ; R#1
+        a.jp(0xCD, PSG_WRITE);                               // call psg_write
+        a.db({0x78, 0x2F, 0x5F, 0x3E, 0x02});                // ld a,b / cpl / ld e,a / ld a,2 ; R#2: ~c
+        a.jp(0xCD, PSG_WRITE);                               // call psg_write
+        a.db({0x78, 0xE6, 0x1F, 0x5F, 0x3E, 0x06});          // ld a,b / and 1Fh / ld e,a / ld a,6 ; R#6: the noise period
+        a.jp(0xCD, PSG_WRITE);                               // call psg_write
+        a.db({0x78, 0x0F, 0x0F, 0xE6, 0x0F, 0x5F, 0x3E, 0x08}); // ld a,b / rrca x2 / and 0Fh / ld e,a / ld a,8 ; R#8: volume sweep
+        a.jp(0xCD, PSG_WRITE);                               // call psg_write
+        a.db({0x78, 0x87, 0x80, 0x5F, 0x3E, 0x0B});          // ld a,b / add a,a / add a,b / ld e,a / ld a,11 ; R#11: c * 3
+        a.jp(0xCD, PSG_WRITE);                               // call psg_write
+        a.db({0x78, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0xE6, 0x07}); // ld a,b / rrca x5 / and 7
+        a.db({0x21, mixers & 0xFF, mixers >> 8, 0x85, 0x6F}); // ld hl,mixers / add a,l / ld l,a
+        a.db({0x5E, 0x3E, 0x07});                            // ld e,(hl) / ld a,7 ; R#7
+        a.jp(0xCD, PSG_WRITE);                               // call psg_write
+        // restart the envelope with the next shape every 16 frames
+        a.db({0x78, 0xE6, 0x0F});                            // ld a,b / and 0Fh
+        a.jr(0x20, loop);                                    // jr nz,loop
+        a.db({0x78, 0x0F, 0x0F, 0x0F, 0x0F, 0xE6, 0x0F});    // ld a,b / rrca x4 / and 0Fh
+        a.db({0x5F, 0x3E, 0x0D});                            // ld e,a / ld a,13 ; R#13
+        a.jp(0xCD, PSG_WRITE);                               // call psg_write
+        a.jp(0xC3, loop);                                    // jp loop
+    }
+
+    static void buildScc(Assembler& a)
+    {
+        header(a, 0xD0); // page 2: the cartridge (slot 1), page 3: RAM
+        int registers = DATA;
+        a.org(registers);
+        a.db({0, 0x00, 1, 0xE0, 7, 0xF5, 0xFF});
+        int sound = DATA + 0x10;
+        a.org(sound);
+        a.db({7, 0xBE, 8, 0x08, 0, 0x80, 1, 0x00, 0xFF}); // a PSG tone on the channel A
+        // periods (0x9880), volumes (0x988A) and the channel enable (0x988F)
+        int scc = DATA + 0x20;
+        a.org(scc);
+        a.db({0x00, 0x01, 0x80, 0x01, 0xC0, 0x00, 0x40, 0x02, 0x20, 0x03, 0x0F, 0x0C, 0x0A, 0x08, 0x06, 0x1F});
+
+        a.org(MAIN);
+        a.db({0x21, registers & 0xFF, registers >> 8});      // ld hl,registers
+        a.jp(0xCD, VDP_REGISTERS);                           // call vdp_registers
+        a.db({0x21, sound & 0xFF, sound >> 8});              // ld hl,sound
+        a.jp(0xCD, PSG_REGISTERS);                           // call psg_registers
+        a.db({0x3E, 0x3F, 0x32, 0x00, 0x90});                // ld a,3Fh / ld (9000h),a ; the SCC is enabled
+        // the waves of the channels 1-4 (128 bytes of a quadratic sequence)
+        a.db({0x21, 0x00, 0x98, 0x06, 0x80, 0xAF, 0x4F});    // ld hl,9800h / ld b,128 / xor a / ld c,a
+        int wave = a.here();
+        a.db({0x77, 0x23, 0x81, 0x0C, 0x0C, 0x0C});          // ld (hl),a / inc hl / add a,c / inc c x3
+        a.jr(0x10, wave);                                    // djnz wave
+        a.db({0x21, scc & 0xFF, scc >> 8});                  // ld hl,scc
+        a.db({0x11, 0x80, 0x98, 0x01, 0x10, 0x00, 0xED, 0xB0}); // ld de,9880h / ld bc,16 / ldir
+
+        int loop = frameLoop(a);
+        a.db({0x3A, FRAME_COUNTER & 0xFF, FRAME_COUNTER >> 8, 0x47}); // ld a,(counter) / ld b,a
+        a.db({0x32, 0x80, 0x98});                            // ld (9880h),a ; the period of the channel 1 sweeps
+        a.db({0x2F, 0x32, 0x84, 0x98});                      // cpl / ld (9884h),a ; the channel 3 sweeps down
+        a.db({0x78, 0x0F, 0x0F, 0x0F, 0xE6, 0x0F});          // ld a,b / rrca x3 / and 0Fh
+        a.db({0x32, 0x8B, 0x98});                            // ld (988Bh),a ; the volume of the channel 2
+        a.db({0x78, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0xE6, 0x03}); // ld a,b / rrca x6 / and 3
+        a.db({0xEE, 0x1F, 0x32, 0x8F, 0x98});                // xor 1Fh / ld (988Fh),a ; the channels 1-2 in turn every 64 frames
+        a.db({0x78, 0xE6, 0x1F, 0xC6, 0x60});                // ld a,b / and 1Fh / add a,60h
+        a.db({0x6F, 0x26, 0x98, 0x70});                      // ld l,a / ld h,98h / ld (hl),b ; a sample of the shared wave
+        a.jp(0xC3, loop);                                    // jp loop
+    }
+
+  public:
+    static const char* name(Program program)
+    {
+        switch (program) {
+            case Program::Screens: return "screens";
+            case Program::Psg: return "psg";
+            default: return "scc";
+        }
+    }
+
+    // rom: 32KB (slot 0), cartridge: 128KB of the Konami SCC mapper for Program::Scc (nullptr: none)
+    static void load(MSX1* msx, Program program, unsigned char* rom, unsigned char* cartridge)
+    {
+        Assembler a(rom);
+        switch (program) {
+            case Program::Screens: buildScreens(a); break;
+            case Program::Psg: buildPsg(a); break;
+            default: buildScc(a); break;
+        }
+        msx->setup(0, 0, rom, 0x8000, "BIOS");
+        if (Program::Scc == program && cartridge) {
+            for (int i = 0; i < 0x20000; i++) cartridge[i] = (unsigned char)(i >> 13);
+            msx->loadRom(cartridge, 0x20000, MSX1_ROM_TYPE_KONAMI_SCC);
+        } else {
+            msx->ejectRom();
+        }
+    }
+
+    // the scripted input of a frame (pad: MSX1_JOY_*, key: the character code of the pressed key or 0)
+    static void input(int frame, unsigned char* pad, unsigned char* key)
+    {
+        *pad = 0;
+        if (20 <= frame && frame < 60) *pad |= MSX1_JOY_RI;
+        if (60 <= frame && frame < 90) *pad |= MSX1_JOY_DW;
+        if (90 <= frame && frame < 120) *pad |= MSX1_JOY_LE | MSX1_JOY_UP;
+        if (150 <= frame && frame < 160) *pad |= MSX1_JOY_T1;
+        *key = (40 <= frame && frame < 46) || (100 <= frame && frame < 130) ? ' ' : 0;
+    }
+};
+
+#endif // TEST_HOMEBREW_HPP
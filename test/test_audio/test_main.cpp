@@ -0,0 +1,127 @@
+/**
+ * vga32-msx - Audio Output Test
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+// Plays the PSG and SCC programs through the sound ring into a WAV file (WavSink pulls the samples at the rate of the DAC),
+// and compares the hash of the recorded samples with the committed golden value.
+// The WAV file is kept for listening when the output differs.
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "msx1.hpp"
+#include "soundring.hpp"
+#include "wavsink.hpp"
+#include "../homebrew.hpp"
+
+static unsigned char ram[0x4000];
+static TMS9918A::Context vram;
+static unsigned char rom[0x8000];
+static unsigned char cartridge[0x20000];
+static SoundRing ring;
+static unsigned char wav[44 + Homebrew::FRAMES * 736 * 2 + 1024];
+
+static unsigned int hash(unsigned int hash, const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static unsigned int getLE(const unsigned char* p, int bytes)
+{
+    unsigned int value = 0;
+    for (int i = 0; i < bytes; i++) value |= (unsigned int)p[i] << (i * 8);
+    return value;
+}
+
+static void play(Homebrew::Program program, bool bandLimited, const char* name, unsigned int golden)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "test_audio_%s.wav", name);
+    MSX1* msx = new MSX1(TMS9918A::ColorMode::RGB555, ram, sizeof(ram), &vram);
+    Homebrew::load(msx, program, rom, cartridge);
+    msx->setBandLimitedSound(bandLimited);
+    ring.clear();
+    ring.resetStats();
+    ring.setLatency(2048);
+    msx->setSoundRing(&ring);
+    WavSink sink;
+    TEST_ASSERT_TRUE_MESSAGE(sink.open(path), "cannot create the WAV file");
+    unsigned int samples = 0;
+    for (int frame = 0; frame < Homebrew::FRAMES; frame++) {
+        unsigned char pad;
+        unsigned char key;
+        Homebrew::input(frame, &pad, &key);
+        msx->tick(pad, 0, key);
+        // 44100Hz of the DAC against the frames of 262 lines of 228 CPU clocks
+        unsigned int total = (unsigned int)((frame + 1) * 44100ULL * 59736 / 3579545);
+        sink.consume(&ring, total - samples);
+        samples = total;
+    }
+    sink.close();
+    delete msx;
+    SoundRing::Stats stats = ring.getStats();
+
+    FILE* fp = fopen(path, "rb");
+    TEST_ASSERT_TRUE_MESSAGE(fp, "cannot read the WAV file");
+    size_t size = fread(wav, 1, sizeof(wav), fp);
+    fclose(fp);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(44 + samples * 2, size, "the WAV file size");
+    TEST_ASSERT_TRUE_MESSAGE(0 == memcmp(wav, "RIFF", 4) && 0 == memcmp(&wav[8], "WAVEfmt ", 8) && 0 == memcmp(&wav[36], "data", 4), "the WAV chunks");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, getLE(&wav[22], 2), "mono");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(44100, getLE(&wav[24], 4), "the sample rate");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(16, getLE(&wav[34], 2), "16 bits");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(samples * 2, getLE(&wav[40], 4), "the data size");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, stats.underruns, "underruns after the priming");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, stats.overruns, "overruns");
+
+    unsigned int result = hash(2166136261U, &wav[44], samples * 2);
+    printf("%s: %u samples, fill %u-%u, hash 0x%08X\n", name, samples, stats.minFill, stats.maxFill, result);
+    if (golden != result) {
+        printf("%s: the output differs (listen to %s)\n", name, path);
+    } else {
+        remove(path);
+    }
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(golden, result, name);
+}
+
+static void test_psg() { play(Homebrew::Program::Psg, false, "psg", 0x332FA8FC); }
+static void test_psg_band_limited() { play(Homebrew::Program::Psg, true, "psg_band_limited", 0xBB254333); }
+static void test_scc() { play(Homebrew::Program::Scc, true, "scc", 0xAF3E8A79); }
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_psg);
+    RUN_TEST(test_psg_band_limited);
+    RUN_TEST(test_scc);
+    return UNITY_END();
+}
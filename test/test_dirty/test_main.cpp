@@ -0,0 +1,100 @@
+/**
+ * vga32-msx - Dirty Tracking Test
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+// Runs each homebrew program with and without the dirty tracking of the VDP (with and without the batch rendering):
+// the display must be the same at every frame, and the ratio of the skipped lines and the render time are reported.
+#include <stdio.h>
+#include <unity.h>
+#include "msx1.hpp"
+#include "../homebrew.hpp"
+
+static unsigned char ram[0x4000];
+static TMS9918A::Context vram;
+static unsigned char rom[0x8000];
+static unsigned char cartridge[0x20000];
+
+struct Run {
+    unsigned int videoHash[Homebrew::FRAMES];
+    TMS9918A::RenderStats stats;
+    unsigned long long vdpNanos;
+};
+
+static void run(Homebrew::Program program, bool dirtyTracking, bool batchRendering, Run* result)
+{
+    MSX1* msx = new MSX1(TMS9918A::ColorMode::RGB555, ram, sizeof(ram), &vram);
+    Homebrew::load(msx, program, rom, cartridge);
+    msx->vdp.setBatchRendering(batchRendering);
+    msx->vdp.setDirtyTracking(dirtyTracking);
+    msx->resetProfile();
+    for (int frame = 0; frame < Homebrew::FRAMES; frame++) {
+        unsigned char pad;
+        unsigned char key;
+        Homebrew::input(frame, &pad, &key);
+        msx->tick(pad, 0, key);
+        result->videoHash[frame] = msx->profile.videoHash;
+    }
+    result->stats = msx->vdp.renderStats;
+    result->vdpNanos = msx->profile.vdpNanos;
+    delete msx;
+}
+
+static void compare(Homebrew::Program program, bool batchRendering, int minSkippedPercent)
+{
+    static Run full;
+    static Run tracked;
+    run(program, false, batchRendering, &full);
+    run(program, true, batchRendering, &tracked);
+    unsigned int lines = tracked.stats.renderedLines + tracked.stats.skippedLines;
+    int skippedPercent = lines ? (int)(tracked.stats.skippedLines * 100ULL / lines) : 0;
+    printf("%s%s: %u of %u lines skipped (%d%%), vdp %llu us -> %llu us\n", Homebrew::name(program), batchRendering ? " (batch)" : "", tracked.stats.skippedLines, lines, skippedPercent, full.vdpNanos / 1000, tracked.vdpNanos / 1000);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(full.stats.renderedLines, lines, "the tracked run must visit the same lines");
+    char message[64];
+    for (int frame = 0; frame < Homebrew::FRAMES; frame++) {
+        snprintf(message, sizeof(message), "%s: frame %d", Homebrew::name(program), frame);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(full.videoHash[frame], tracked.videoHash[frame], message);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(minSkippedPercent <= skippedPercent, "too few lines skipped");
+}
+
+// a name row and the sprites change at every frame, the backdrop while the space key is held, and the mode every 32 frames
+static void test_screens() { compare(Homebrew::Program::Screens, false, 30); }
+static void test_screens_batch() { compare(Homebrew::Program::Screens, true, 30); }
+// static screens
+static void test_psg() { compare(Homebrew::Program::Psg, false, 95); }
+static void test_scc() { compare(Homebrew::Program::Scc, true, 95); }
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_screens);
+    RUN_TEST(test_screens_batch);
+    RUN_TEST(test_psg);
+    RUN_TEST(test_scc);
+    return UNITY_END();
+}
@@ -0,0 +1,114 @@
+/**
+ * vga32-msx - Golden Output Test
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+// Runs each homebrew program for a fixed number of frames with the scripted input, and compares the per-frame
+// video and sound hashes (MSX1_PROFILE) chained up to each checkpoint with the committed golden values.
+// The time spent in each component is reported, to check a change for both correctness and speed.
+#include <stdio.h>
+#include <unity.h>
+#include "msx1.hpp"
+#include "../homebrew.hpp"
+
+static const int CHECKPOINT_FRAMES = 30;
+static const int CHECKPOINTS = Homebrew::FRAMES / CHECKPOINT_FRAMES;
+
+// [program][0: video, 1: sound][checkpoint]
+static const unsigned int golden[Homebrew::PROGRAMS][2][CHECKPOINTS] = {
+    {{0xA21BE71A, 0xCD155325, 0xFDB89A63, 0xB9D35817, 0x709D62ED, 0xBF656426, 0x393460C7, 0xE1210EF1}, {0x0BA6D9F7, 0xF6571EC3, 0xB917FCBF, 0xD6AB3BE3, 0xA3085027, 0x247DAC1B, 0xC34DFA57, 0x09A3AAA3}}, // screens
+    {{0x8752B2E5, 0x5076EC85, 0xB67B41A5, 0x6409A545, 0x92A4AA65, 0xC306EE05, 0x10A6E125, 0x8CC6B4C5}, {0xE48F1EAF, 0x7AE32DFD, 0x00819433, 0x9484B91D, 0x229EF8E7, 0xB817430C, 0x7C9C7784, 0x2AA875DA}}, // psg
+    {{0x143CB1B5, 0x5198E0A5, 0x09B27D95, 0xF2695805, 0x7E7BC4F5, 0x1F51E3E5, 0xE2FFE4D5, 0x52745645}, {0xF1421B1E, 0x2CA2B77C, 0x393B07B6, 0x2C19BA0B, 0x32FC9B52, 0x0D42CA68, 0x2A3F2AE4, 0x50B0C506}}, // scc
+};
+
+static unsigned char ram[0x4000];
+static TMS9918A::Context vram;
+static unsigned char rom[0x8000];
+static unsigned char cartridge[0x20000];
+
+static unsigned int chain(unsigned int hash, unsigned int value)
+{
+    for (int i = 0; i < 4; i++) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static void run(Homebrew::Program program)
+{
+    MSX1* msx = new MSX1(TMS9918A::ColorMode::RGB555, ram, sizeof(ram), &vram);
+    Homebrew::load(msx, program, rom, cartridge);
+    msx->resetProfile();
+    unsigned int video = 2166136261U;
+    unsigned int sound = 2166136261U;
+    unsigned int result[2][CHECKPOINTS];
+    for (int frame = 0; frame < Homebrew::FRAMES; frame++) {
+        unsigned char pad;
+        unsigned char key;
+        Homebrew::input(frame, &pad, &key);
+        msx->tick(pad, 0, key);
+        video = chain(video, msx->profile.videoHash);
+        sound = chain(sound, msx->profile.soundHash);
+        if (0 == (frame + 1) % CHECKPOINT_FRAMES) {
+            result[0][frame / CHECKPOINT_FRAMES] = video;
+            result[1][frame / CHECKPOINT_FRAMES] = sound;
+        }
+    }
+    printf("%s: %d frames, cpu %llu us, vdp %llu us, psg %llu us\n", Homebrew::name(program), msx->profile.frames, msx->profile.cpuNanos / 1000, msx->profile.vdpNanos / 1000, msx->profile.psgNanos / 1000);
+    delete msx;
+
+    int index = (int)program;
+    if (memcmp(result, golden[index], sizeof(result))) {
+        // the values to be committed when the change of the output is intended
+        printf("    {{");
+        for (int i = 0; i < CHECKPOINTS; i++) printf(i ? ", 0x%08X" : "0x%08X", result[0][i]);
+        printf("}, {");
+        for (int i = 0; i < CHECKPOINTS; i++) printf(i ? ", 0x%08X" : "0x%08X", result[1][i]);
+        printf("}}, // %s\n", Homebrew::name(program));
+    }
+    char message[64];
+    for (int i = 0; i < CHECKPOINTS; i++) {
+        snprintf(message, sizeof(message), "%s: video up to the frame %d", Homebrew::name(program), (i + 1) * CHECKPOINT_FRAMES);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(golden[index][0][i], result[0][i], message);
+        snprintf(message, sizeof(message), "%s: sound up to the frame %d", Homebrew::name(program), (i + 1) * CHECKPOINT_FRAMES);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(golden[index][1][i], result[1][i], message);
+    }
+}
+
+static void test_screens() { run(Homebrew::Program::Screens); }
+static void test_psg() { run(Homebrew::Program::Psg); }
+static void test_scc() { run(Homebrew::Program::Scc); }
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_screens);
+    RUN_TEST(test_psg);
+    RUN_TEST(test_scc);
+    return UNITY_END();
+}
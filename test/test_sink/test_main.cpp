@@ -0,0 +1,156 @@
+/**
+ * vga32-msx - Display Sink Test
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 vga32-msx contributors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+// Renders the screens program through a mock display sink of separate line buffers (as the VGA scanlines),
+// and compares each frame with the rendering into the display buffer of the VDP.
+// The VDP must render in place: the sink receives the lines it handed out, so no byte is copied.
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "msx1.hpp"
+#include "../homebrew.hpp"
+
+static unsigned char ram[0x4000];
+static TMS9918A::Context vram;
+static unsigned char rom[0x8000];
+
+class MockSink
+{
+  public:
+    static const int GUARD = 16;
+    static const unsigned char GUARD_VALUE = 0xA5;
+
+    unsigned char lines[192][GUARD + 512 + GUARD];
+    int pitch;
+    unsigned int requestedLines;
+    unsigned int renderedLines;
+    unsigned int foreignLines;  // lines notified with a destination that the sink did not hand out
+    unsigned long long copiedBytes; // what the sink would copy into its lines for them
+
+    MockSink(int pitch) : pitch(pitch), requestedLines(0), renderedLines(0), foreignLines(0), copiedBytes(0)
+    {
+        memset(this->lines, GUARD_VALUE, sizeof(this->lines));
+    }
+
+    unsigned char* line(int y) { return &this->lines[y][GUARD]; }
+
+    bool isGuardIntact()
+    {
+        for (int y = 0; y < 192; y++) {
+            for (int i = 0; i < GUARD; i++) {
+                if (GUARD_VALUE != this->lines[y][i] || GUARD_VALUE != this->lines[y][GUARD + this->pitch + i]) return false;
+            }
+        }
+        return true;
+    }
+
+    static void* getLine(void* arg, int frame, int y)
+    {
+        MockSink* sink = (MockSink*)arg;
+        sink->requestedLines++;
+        return sink->line(y);
+    }
+
+    static void lineRendered(void* arg, int frame, int y, void* dst)
+    {
+        MockSink* sink = (MockSink*)arg;
+        sink->renderedLines++;
+        if (dst != sink->line(y)) {
+            sink->foreignLines++;
+            memcpy(sink->line(y), dst, sink->pitch);
+            sink->copiedBytes += sink->pitch;
+        }
+    }
+};
+
+static unsigned int hash(unsigned int hash, const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static void compare(TMS9918A::ColorMode colorMode, const char* name)
+{
+    static unsigned int expected[Homebrew::FRAMES];
+    MSX1* msx = new MSX1(colorMode, ram, sizeof(ram), &vram);
+    Homebrew::load(msx, Homebrew::Program::Screens, rom, nullptr);
+    int pitch = msx->vdp.displayPitch;
+    for (int frame = 0; frame < Homebrew::FRAMES; frame++) {
+        unsigned char pad;
+        unsigned char key;
+        Homebrew::input(frame, &pad, &key);
+        msx->tick(pad, 0, key);
+        expected[frame] = hash(2166136261U, msx->vdp.display, (size_t)pitch * 192);
+    }
+    delete msx;
+
+    MockSink* sink = new MockSink(pitch);
+    msx = new MSX1(colorMode, ram, sizeof(ram), &vram);
+    Homebrew::load(msx, Homebrew::Program::Screens, rom, nullptr);
+    TMS9918A::DisplaySink displaySink = {sink, MockSink::getLine, MockSink::lineRendered};
+    msx->vdp.useDisplaySink(displaySink);
+    msx->vdp.setBatchRendering(true);
+    TEST_ASSERT_TRUE_MESSAGE(nullptr == msx->vdp.display, "the display buffer must be released");
+    char message[64];
+    for (int frame = 0; frame < Homebrew::FRAMES; frame++) {
+        unsigned char pad;
+        unsigned char key;
+        Homebrew::input(frame, &pad, &key);
+        msx->tick(pad, 0, key);
+        unsigned int h = 2166136261U;
+        for (int y = 0; y < 192; y++) h = hash(h, sink->line(y), pitch);
+        snprintf(message, sizeof(message), "%s: frame %d", name, frame);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(expected[frame], h, message);
+    }
+    delete msx;
+    printf("%s: %u lines requested, %u rendered, %llu bytes copied\n", name, sink->requestedLines, sink->renderedLines, sink->copiedBytes);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(192 * Homebrew::FRAMES, sink->renderedLines, "every line of every frame is output");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sink->requestedLines, sink->renderedLines, "every requested line is output");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, sink->foreignLines, "the lines must be rendered in place");
+    TEST_ASSERT_TRUE_MESSAGE(0 == sink->copiedBytes, "no byte is copied");
+    TEST_ASSERT_TRUE_MESSAGE(sink->isGuardIntact(), "the lines must not be overrun");
+    delete sink;
+}
+
+static void test_rgb555() { compare(TMS9918A::ColorMode::RGB555, "RGB555"); }
+static void test_rgb222_swap() { compare(TMS9918A::ColorMode::RGB222_Swap, "RGB222_Swap"); }
+static void test_indexed4() { compare(TMS9918A::ColorMode::Indexed4, "Indexed4"); }
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rgb555);
+    RUN_TEST(test_rgb222_swap);
+    RUN_TEST(test_indexed4);
+    return UNITY_END();
+}